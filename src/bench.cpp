@@ -0,0 +1,630 @@
+/* C++ Search Engine Benchmarks by Vasileios Sioros */
+
+#include "engine.h"
+#include "trie.h"
+#include "hash.h"
+#include "index.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+
+static const unsigned maxSamples = 1000U, maxResults = 10U, maxTerms = 10000U;
+static const unsigned vocabulary = 200000U, maxFuzzy = 200U;
+
+// Sample Query Implementation:
+// Each query consists of 1 to 4 words of a random document of the file
+struct Samples
+{
+    unsigned size;
+    char queries[maxSamples][512];
+
+    Samples(const char *, const unsigned);
+
+    // Copy the i-th query into buffer, since searching consumes its input
+    char * get(const unsigned i, char * buffer) const { return std::strcpy(buffer, queries[i]); }
+};
+
+Samples::Samples(const char * filename, const unsigned count)
+:
+size(0)
+{
+    std::ifstream ifs(filename);
+
+    unsigned lines = 0;
+    for (std::string line; std::getline(ifs, line); lines++);
+
+    std::srand(1U);
+
+    for (; size < count && size < maxSamples && lines; size++)
+    {
+        const unsigned target = (unsigned) std::rand() % lines, words = 1U + (unsigned) std::rand() % 4U;
+
+        ifs.clear(); ifs.seekg(std::ios::beg);
+
+        std::string line;
+        for (unsigned i = 0; i <= target; i++)
+            std::getline(ifs, line);
+
+        char * const buffer = new char[line.size() + 1];
+        std::strcpy(buffer, line.c_str());
+
+        // Gather every word of the document (ignoring its ID)
+        unsigned total = 0;
+        char * tokens[4096];
+        for (char * token = std::strtok(buffer, " \t"); token && total < 4096; token = std::strtok(nullptr, " \t"))
+            tokens[total++] = token;
+
+        queries[size][0] = '\0';
+        for (unsigned i = 0; i < words && total > 1; i++)
+        {
+            const char * const word = tokens[1 + (unsigned) std::rand() % (total - 1)];
+            if (std::strlen(queries[size]) + std::strlen(word) + 2 >= sizeof(queries[size]))
+                break;
+
+            std::strcat(queries[size], " ");
+            std::strcat(queries[size], word);
+        }
+
+        delete[] buffer;
+    }
+}
+
+static double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compare each compiled ranking policy against the generic BM25 path
+static void ranking(const char * filename, const Samples& samples, const unsigned iterations)
+{
+    const char * names[] = { "generic", "bm25", "bm25+", "bm25l", "tfidf" };
+
+    std::cout << "\n[Ranking functions: " << samples.size << " queries x " << iterations << " iterations]" << std::endl;
+    std::cout << std::setw(10) << "ranking" << std::setw(14) << "us/query" << std::setw(10) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned r = Engine::GENERIC; r <= Engine::TFIDF; r++)
+    {
+        const Engine * const eng = Engine::validate(filename, maxResults, (Engine::Ranking) r);
+        if (!eng)
+            return;
+
+        Engine::Result results[maxResults];
+        char buffer[512]; double checksum = 0.0;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned it = 0; it < iterations; it++)
+            for (unsigned i = 0; i < samples.size; i++)
+            {
+                const unsigned size = eng->query(samples.get(i, buffer), results);
+                if (size)
+                    checksum += results[0].score;
+            }
+
+        const double us = elapsed(start) / (double) (iterations * samples.size);
+        if (r == Engine::GENERIC)
+            baseline = us;
+
+        std::cout << std::setw(10) << names[r] << std::setw(14) << std::fixed << std::setprecision(3) << us
+                  << std::setw(9) << std::setprecision(2) << baseline / us << 'x'
+                  << "   (checksum " << std::setprecision(3) << checksum << ')' << std::endl;
+
+        delete eng;
+    }
+}
+
+// Compare the exact match lookup latency of the lexicon backends, for terms
+// of the file (hits) as well as terms absent from it (misses), along with
+// the memory their structure occupies per term (Posting Lists excluded)
+static void lexicon(const char * filename, const unsigned iterations)
+{
+    std::ifstream ifs(filename);
+
+    unsigned lines = 0;
+    for (std::string line; std::getline(ifs, line); lines++);
+
+    Lexicon * lexicons[] = { new Trie(lines), new Hash(lines), new Hash(lines), new Trie(lines) };
+    const char * names[] = { "trie", "hash", "mph", "louds" };
+
+    char (* const terms)[512] = new char[2 * maxTerms][512];
+    unsigned count = 0;
+
+    ifs.clear(); ifs.seekg(std::ios::beg);
+
+    char word[512];
+    for (unsigned id = 0; id < lines; id++)
+    {
+        ifs >> word;
+        while (ifs.peek() != '\n' && ifs >> word)
+        {
+            for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+                lexicons[i]->add(word, id);
+
+            // Keep every 10th word as a hit and the same word, misspelled, as a miss
+            if (count < 2 * maxTerms && std::rand() % 10 == 0 && std::strlen(word) < sizeof(word) - 2)
+            {
+                std::strcpy(terms[count++], word);
+                std::strcat(std::strcpy(terms[count++], word), "#");
+            }
+        }
+    }
+
+    // Count the distinct terms
+    struct Counter
+    {
+        static void visit(const char *, const PList *, void * arg) { (*(unsigned *) arg)++; }
+    };
+
+    unsigned distinct = 0;
+    lexicons[0]->visit(Counter::visit, &distinct);
+
+    lexicons[2]->freeze();
+
+    Lexicon * const louds = lexicons[3]->freeze();
+    delete lexicons[3];
+    lexicons[3] = louds;
+
+    std::cout << "\n[Lexicon lookups: " << count << " terms x " << iterations << " iterations, "
+              << distinct << " terms vocabulary]" << std::endl;
+    std::cout << std::setw(10) << "lexicon" << std::setw(14) << "ns/lookup" << std::setw(10) << "speedup"
+              << std::setw(14) << "bytes/term" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+    {
+        unsigned found = 0;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned it = 0; it < iterations; it++)
+            for (unsigned t = 0; t < count; t++)
+                found += (lexicons[i]->lookup(terms[t]) != nullptr);
+
+        const double ns = 1000.0 * elapsed(start) / (double) (iterations * count);
+        if (!i)
+            baseline = ns;
+
+        std::cout << std::setw(10) << names[i] << std::setw(14) << std::fixed << std::setprecision(3) << ns
+                  << std::setw(9) << std::setprecision(2) << baseline / ns << 'x'
+                  << std::setw(14) << (double) lexicons[i]->bytes() / (double) distinct
+                  << "   (found " << found / iterations << ')' << std::endl;
+    }
+
+    for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+        delete lexicons[i];
+
+    delete[] terms;
+}
+
+// Compare the latency of fuzzy lookups on a large vocabulary (the terms of
+// the file padded with random words) between the trie's Levenshtein automaton
+// walk, the frozen hash table's walk of its sorted terms and the hash table's
+// scan of its slots
+static void fuzzy(const char * filename, const unsigned iterations)
+{
+    Lexicon * lexicons[] = { new Trie(1), new Hash(1), new Hash(1) };
+    const char * names[] = { "trie", "mph", "hash" };
+
+    std::ifstream ifs(filename);
+
+    char (* const terms)[512] = new char[maxFuzzy][512];
+    unsigned count = 0, size = 0;
+
+    // Keep every 100th word, with one of its letters replaced, as a query
+    char word[512];
+    while (ifs >> word && size < vocabulary)
+    {
+        for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+            lexicons[i]->add(word, 0);
+
+        size++;
+
+        const unsigned len = (unsigned) std::strlen(word);
+        if (count < maxFuzzy && len > 3 && std::rand() % 100 == 0)
+        {
+            std::strcpy(terms[count], word);
+            terms[count++][(unsigned) std::rand() % len] = (char) ('a' + std::rand() % 26);
+        }
+    }
+
+    for (; size < vocabulary; size++)
+    {
+        const unsigned len = 3U + (unsigned) std::rand() % 8U;
+        for (unsigned i = 0; i < len; i++)
+            word[i] = (char) ('a' + std::rand() % 26);
+
+        word[len] = '\0';
+
+        for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+            lexicons[i]->add(word, 0);
+    }
+
+    Lexicon * const frozen = lexicons[1]->freeze();
+    if (frozen != lexicons[1])
+    {
+        delete lexicons[1];
+        lexicons[1] = frozen;
+    }
+
+    std::cout << "\n[Fuzzy lookups: " << count << " terms x " << iterations << " iterations, ~"
+              << vocabulary << " terms vocabulary]" << std::endl;
+    std::cout << std::setw(10) << "lexicon" << std::setw(10) << "distance" << std::setw(14) << "us/lookup" << std::setw(10) << "speedup" << std::endl;
+
+    Lexicon::Match matches[maxResults];
+    for (unsigned distance = 1; distance <= 2; distance++)
+    {
+        double baseline = 0.0;
+        for (unsigned i = sizeof(lexicons) / sizeof(lexicons[0]); i-- > 0; )
+        {
+            unsigned found = 0;
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (unsigned it = 0; it < iterations; it++)
+                for (unsigned t = 0; t < count; t++)
+                    found += lexicons[i]->fuzzy(terms[t], distance, matches, maxResults);
+
+            const double us = elapsed(start) / (double) (iterations * count);
+            if (i == sizeof(lexicons) / sizeof(lexicons[0]) - 1)
+                baseline = us;
+
+            std::cout << std::setw(10) << names[i] << std::setw(10) << distance << std::setw(14) << std::fixed << std::setprecision(3) << us
+                      << std::setw(9) << std::setprecision(2) << baseline / us << 'x'
+                      << "   (found " << found / iterations << ')' << std::endl;
+        }
+    }
+
+    for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+        delete lexicons[i];
+
+    delete[] terms;
+}
+
+// Confirm that a fuzzy term expands to the closest terms first, the term itself
+// leading, however many more frequent neighbours (within the distance) it has
+static void expansion()
+{
+    static const unsigned documents = 64U, max = 5U;
+
+    const char term[] = "cart";
+    const char * neighbours[] = { "card", "care", "cars", "carts", "cat", "art", "part", "dart", "carry", "scar" };
+
+    std::cout << "\n[Fuzzy expansion: ~" << term << " (1 document) amongst " << sizeof(neighbours) / sizeof(neighbours[0])
+              << " neighbours (" << documents << " documents each), top " << max << ']' << std::endl;
+    std::cout << std::setw(10) << "lexicon" << std::setw(10) << "first" << std::setw(12) << "distances" << std::endl;
+
+    Lexicon * lexicons[] = { new Trie(documents), new Hash(documents) };
+    const char * names[][2] = { { "trie", "louds" }, { "hash", "mph" } };
+
+    for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+    {
+        lexicons[i]->add(term, 0);
+        for (unsigned id = 0; id < documents; id++)
+            for (unsigned n = 0; n < sizeof(neighbours) / sizeof(neighbours[0]); n++)
+                lexicons[i]->add(neighbours[n], id);
+
+        // Once as built and once frozen
+        for (unsigned frozen = 0; frozen < 2; frozen++)
+        {
+            if (frozen)
+            {
+                Lexicon * const other = lexicons[i]->freeze();
+                if (other != lexicons[i])
+                {
+                    delete lexicons[i];
+                    lexicons[i] = other;
+                }
+            }
+
+            Lexicon::Match matches[max];
+            const unsigned found = lexicons[i]->fuzzy(term, 2, matches, max);
+
+            char distances[2 * max + 1] = { '\0' };
+            for (unsigned m = 0; m < found; m++)
+                std::sprintf(distances + 2 * m, "%u ", matches[m].distance);
+
+            std::cout << std::setw(10) << names[i][frozen] << std::setw(10) << (found ? matches[0].term : "-")
+                      << std::setw(12) << distances << std::endl;
+        }
+    }
+
+    for (unsigned i = 0; i < sizeof(lexicons) / sizeof(lexicons[0]); i++)
+        delete lexicons[i];
+}
+
+// Compare running the sample queries one at a time against a single shared scan batch
+static void batch(const char * filename, const Samples& samples, const unsigned iterations)
+{
+    const Engine * const eng = Engine::validate(filename, maxResults);
+    if (!eng)
+        return;
+
+    std::cout << "\n[Shared scan: " << samples.size << " queries x " << iterations << " iterations]" << std::endl;
+    std::cout << std::setw(12) << "execution" << std::setw(14) << "us/query" << std::setw(10) << "speedup" << std::endl;
+
+    Engine::Result * const results = new Engine::Result[samples.size * maxResults];
+    unsigned * const sizes = new unsigned[samples.size];
+
+    char (* const buffers)[512] = new char[samples.size][512];
+    char ** const inputs = new char*[samples.size];
+
+    double baseline = 0.0, checksum = 0.0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned it = 0; it < iterations; it++)
+        for (unsigned i = 0; i < samples.size; i++)
+            if (eng->query(samples.get(i, buffers[i]), results))
+                checksum += results[0].score;
+
+    baseline = elapsed(start) / (double) (iterations * samples.size);
+
+    std::cout << std::setw(12) << "sequential" << std::setw(14) << std::fixed << std::setprecision(3) << baseline
+              << std::setw(9) << std::setprecision(2) << 1.0 << 'x'
+              << "   (checksum " << std::setprecision(3) << checksum << ')' << std::endl;
+
+    checksum = 0.0;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned it = 0; it < iterations; it++)
+    {
+        for (unsigned i = 0; i < samples.size; i++)
+            inputs[i] = samples.get(i, buffers[i]);
+
+        eng->batch(inputs, samples.size, results, sizes);
+
+        for (unsigned i = 0; i < samples.size; i++)
+            if (sizes[i])
+                checksum += results[i * maxResults].score;
+    }
+
+    const double us = elapsed(start) / (double) (iterations * samples.size);
+
+    std::cout << std::setw(12) << "batch" << std::setw(14) << std::fixed << std::setprecision(3) << us
+              << std::setw(9) << std::setprecision(2) << baseline / us << 'x'
+              << "   (checksum " << std::setprecision(3) << checksum << ')' << std::endl;
+
+    delete[] inputs;
+    delete[] buffers;
+    delete[] sizes;
+    delete[] results;
+
+    delete eng;
+}
+
+// Compare scanning each query's documents on a single thread against
+// partitioning them across the hardware threads (at least two)
+static void parallel(const char * filename, const Samples& samples, const unsigned iterations)
+{
+    const unsigned hardware = std::thread::hardware_concurrency(), threads[] = { 1U, hardware > 1U ? hardware : 2U };
+
+    std::cout << "\n[Parallel scan: " << samples.size << " queries x " << iterations << " iterations]" << std::endl;
+    std::cout << std::setw(10) << "threads" << std::setw(14) << "us/query" << std::setw(10) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned t = 0; t < 2; t++)
+    {
+        const Engine * const eng = Engine::validate(filename, maxResults, Engine::BM25, Engine::TRIE, threads[t]);
+        if (!eng)
+            return;
+
+        Engine::Result results[maxResults];
+        char buffer[512]; double checksum = 0.0;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned it = 0; it < iterations; it++)
+            for (unsigned i = 0; i < samples.size; i++)
+                if (eng->query(samples.get(i, buffer), results))
+                    checksum += results[0].score;
+
+        const double us = elapsed(start) / (double) (iterations * samples.size);
+        if (!t)
+            baseline = us;
+
+        std::cout << std::setw(10) << threads[t] << std::setw(14) << std::fixed << std::setprecision(3) << us
+                  << std::setw(9) << std::setprecision(2) << baseline / us << 'x'
+                  << "   (checksum " << std::setprecision(3) << checksum << ')' << std::endl;
+
+        delete eng;
+    }
+}
+
+// Compare the full index against the copies pruneIndex writes next to the file, term and document
+// centric: the postings they keep, the latency of short (the sample queries) and long ("more like
+// this", the highest weighted terms of a random document) queries and the overlap of the top results
+static void pruning(const char * filename, const Samples& samples, const unsigned iterations)
+{
+    static const unsigned longTerms = 100U;
+
+    const char * names[] = { "full", "term", "document" };
+    const Engine::Pruning methods[] = { Engine::TERM_CENTRIC, Engine::DOCUMENT_CENTRIC };
+    const double epsilon = 0.5;
+
+    char prefix[512];
+    std::snprintf(prefix, sizeof(prefix), "%s.pruned", filename);
+
+    const Engine * engines[] = { Engine::validate(filename, maxResults), nullptr, nullptr };
+    for (unsigned e = 1; e < 3 && engines[0]; e++)
+    {
+        if (Engine::pruneIndex(filename, prefix, maxResults, methods[e - 1], epsilon))
+            engines[e] = Engine::open(prefix, maxResults);
+
+        Index::Files::remove(prefix);
+
+        if (!engines[e])
+            break;
+    }
+
+    if (!engines[0] || !engines[1] || !engines[2])
+    {
+        for (unsigned e = 0; e < 3; e++)
+            delete engines[e];
+
+        return;
+    }
+
+    // Long queries consist of the words (i.e. everything but the ID) of a random document
+    std::ifstream ifs(filename);
+
+    unsigned lines = 0;
+    for (std::string line; std::getline(ifs, line); lines++);
+
+    char ** const documents = new char*[samples.size];
+
+    std::srand(1U);
+    for (unsigned s = 0; s < samples.size; s++)
+    {
+        const unsigned target = (unsigned) std::rand() % lines;
+
+        ifs.clear(); ifs.seekg(std::ios::beg);
+
+        std::string line;
+        for (unsigned i = 0; i <= target; i++)
+            std::getline(ifs, line);
+
+        const unsigned long id = line.find_first_not_of(" \t"), words = line.find_first_of(" \t", id);
+
+        documents[s] = new char[line.size() + 1];
+        std::strcpy(documents[s], words == std::string::npos ? "" : line.c_str() + words);
+    }
+
+    Engine::Result * const results[] = { new Engine::Result[samples.size * maxResults],
+                                         new Engine::Result[samples.size * maxResults],
+                                         new Engine::Result[samples.size * maxResults] };
+    unsigned * const sizes[] = { new unsigned[samples.size], new unsigned[samples.size], new unsigned[samples.size] };
+
+    double latency[2][3], overlap[2][3];
+
+    for (unsigned kind = 0; kind < 2; kind++)
+    {
+        // The engines take turns answering every sample in a pass of their own: a first, untimed
+        // round warms them up and each then keeps its fastest pass, so that the order does not matter
+        for (unsigned round = 0; round <= iterations; round++)
+            for (unsigned e = 0; e < 3; e++)
+            {
+                char buffer[512];
+
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (unsigned s = 0; s < samples.size; s++)
+                    sizes[e][s] = (kind ? engines[e]->similar(documents[s], longTerms, results[e] + s * maxResults)
+                                        : engines[e]->query(samples.get(s, buffer), results[e] + s * maxResults));
+
+                const double us = elapsed(start) / (double) samples.size;
+                if (round == 1 || (round > 1 && us < latency[kind][e]))
+                    latency[kind][e] = us;
+            }
+
+        // The fraction of the full index's top results that each engine returns as well
+        for (unsigned e = 0; e < 3; e++)
+        {
+            unsigned compared = 0; overlap[kind][e] = 0.0;
+            for (unsigned s = 0; s < samples.size; s++)
+            {
+                if (!sizes[0][s])
+                    continue;
+
+                const Engine::Result * const reference = results[0] + s * maxResults, * const candidate = results[e] + s * maxResults;
+
+                unsigned common = 0;
+                for (unsigned i = 0; i < sizes[0][s]; i++)
+                    for (unsigned j = 0; j < sizes[e][s]; j++)
+                        if (reference[i].id == candidate[j].id)
+                        {
+                            common++;
+                            break;
+                        }
+
+                overlap[kind][e] += (double) common / (double) sizes[0][s];
+                compared++;
+            }
+
+            overlap[kind][e] /= (compared ? compared : 1);
+        }
+    }
+
+    struct Count
+    {
+        unsigned long postings;
+
+        static void visit(const char *, const PList * plist, void * arg)
+        {
+            ((Count *) arg)->postings += plist->documentNum;
+        }
+    };
+
+    std::cout << "\n[Static pruning: epsilon " << epsilon << ", " << samples.size << " short and long queries, fastest of "
+              << iterations << " passes]" << std::endl;
+    std::cout << std::setw(10) << "index" << std::setw(12) << "postings"
+              << std::setw(14) << "short us" << std::setw(10) << "speedup" << std::setw(10) << "overlap"
+              << std::setw(14) << "long us" << std::setw(10) << "speedup" << std::setw(10) << "overlap" << std::endl;
+
+    Count full = { 0UL };
+    engines[0]->vocabulary(Count::visit, &full);
+
+    for (unsigned e = 0; e < 3; e++)
+    {
+        Count count = { 0UL };
+        engines[e]->vocabulary(Count::visit, &count);
+
+        std::cout << std::setw(10) << names[e] << std::setw(11) << std::fixed << std::setprecision(1)
+                  << 100.0 * (double) count.postings / (double) (full.postings ? full.postings : 1) << '%';
+
+        for (unsigned kind = 0; kind < 2; kind++)
+            std::cout << std::setw(14) << std::setprecision(3) << latency[kind][e]
+                      << std::setw(9) << std::setprecision(2) << latency[kind][0] / latency[kind][e] << 'x'
+                      << std::setw(9) << std::setprecision(1) << 100.0 * overlap[kind][e] << '%';
+
+        std::cout << std::endl;
+    }
+
+    // A pruned engine picks the terms of a long query from its own lexicon,
+    // so the engines answer the same document but not quite the same query
+    std::cout << "(long queries: the " << longTerms << " highest weighted terms of a document, picked by each engine from its own lexicon)" << std::endl;
+
+    for (unsigned e = 0; e < 3; e++)
+    {
+        delete[] sizes[e];
+        delete[] results[e];
+        delete engines[e];
+    }
+
+    for (unsigned s = 0; s < samples.size; s++)
+        delete[] documents[s];
+
+    delete[] documents;
+}
+
+int main(int argc, char * argv[])
+{
+    enum { FILE_FLAG = 1, FILE_INPUT };
+    const char error[] = "<Error>: Usage: ./bench -i docfile [-n iterations]";
+
+    if (argc < 3 || std::strcmp(argv[FILE_FLAG], "-i"))
+    {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+
+    int iterations = 10;
+    if (argc > FILE_INPUT + 2 && (std::strcmp(argv[FILE_INPUT + 1], "-n") || (iterations = std::atoi(argv[FILE_INPUT + 2])) <= 0))
+    {
+        std::cerr << error << std::endl;
+        return -2;
+    }
+
+    const Samples * const samples = new Samples(argv[FILE_INPUT], maxSamples);
+
+    ranking(argv[FILE_INPUT], *samples, (unsigned) iterations);
+    lexicon(argv[FILE_INPUT], (unsigned) iterations);
+    fuzzy(argv[FILE_INPUT], (unsigned) iterations);
+    expansion();
+    batch(argv[FILE_INPUT], *samples, (unsigned) iterations);
+    parallel(argv[FILE_INPUT], *samples, (unsigned) iterations);
+    pruning(argv[FILE_INPUT], *samples, (unsigned) iterations);
+
+    delete samples;
+
+    return 0;
+}
@@ -2,14 +2,20 @@
 
 #include "engine.h"
 #include "trie.h"
+#include "hash.h"
 #include "heap.h"
+#include "index.h"
+#include "ranking.h"
+#include "trace.h"
+#include "pool.h"
+#include "renderer.h"
 #include <fstream>
 #include <iostream>
 #include <cstring>
 #include <cctype>
-#include <sys/ioctl.h>
-#include <unistd.h>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
 
 // Error Messages:
 static const char * Message[] =
@@ -20,9 +26,41 @@ static const char * Message[] =
     [Engine::Code::ID_OUT_OF_RANGE]  = "<Error>: Document ID out of range",
     [Engine::Code::WORD_NOT_FOUND]   = "<Error>: No occurrences of the specified word",
     [Engine::Code::NO_VALID_INPUT]   = "<Error>: No valid input",
-    [Engine::Code::EMPTY_DOC]        = "<Error>: A document appears to be empty"
+    [Engine::Code::EMPTY_DOC]        = "<Error>: A document appears to be empty",
+    [Engine::Code::CANNOT_WRITE_FILE] = "<Error>: Unable to write the index files",
+    [Engine::Code::INVALID_INDEX]    = "<Error>: The index files are malformed or inconsistent",
+    [Engine::Code::DID_YOU_MEAN]     = "<Message>: Did you mean"
 };
 
+// Document Checks shared by validate and build:
+// Confirm the document ID read follows the previous one
+static bool follows(const char * docID, int& previousID, const unsigned lines)
+{
+    const int currentID = std::atoi(docID);
+    if (currentID != previousID + 1)
+    {
+        std::cerr << Message[Engine::Code::INVALID_ID_READ] << std::endl;
+        std::cerr << lines << "| " << docID << "..." << std::endl;
+        return false;
+    }
+
+    previousID = currentID;
+
+    return true;
+}
+
+// Confirm the document is not completely blank
+static bool filled(const unsigned length, const int currentID)
+{
+    if (!length)
+    {
+        std::cerr << Message[Engine::Code::EMPTY_DOC]  << " (" << currentID << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 // File Info Implementation:
 Engine::Info::Info(const unsigned lines)
 :
@@ -43,13 +81,26 @@ Engine::Info::~Info()
 }
 
 // Search Engine Implementation:
-const unsigned Engine::maxQueries = 10U;
+const unsigned Engine::longQuery = 10U;
+const unsigned Engine::maxExpansions = 5U;
+const unsigned Engine::maxSuggestions = 3U;
+const unsigned Engine::batchBudget = 1U << 17;
+const unsigned long Engine::parallelWork = 1UL << 18;
+const unsigned Engine::minPartition = 1U << 12;
 
-Engine::Engine(std::ifstream& ifs, const Info * info, const unsigned maxResults, const double k, const double b)
+Engine::Engine(const Info * info, const unsigned maxResults, const Ranking ranking, const Backend backend, const unsigned threads, const double k, const double b)
 :
-trie(info->lines), info(info), maxResults(maxResults), avgdl(0.0), k(k), b(b)
+lexicon(backend == TRIE || backend == LOUDS ? (Lexicon *) new Trie(info->lines) : (Lexicon *) new Hash(info->lines)), info(info), maxResults(maxResults), avgdl(0.0), k(k), b(b), ranking(ranking), norms(new double[info->lines]),
+pool(threads > 1 ? new Pool(threads) : nullptr)
 {
-    double sum = 0.0;
+}
+
+Engine::Engine(std::ifstream& ifs, const Info * info, const unsigned maxResults, const Ranking ranking, const Backend backend, const unsigned threads, const double k, const double b)
+:
+Engine(info, maxResults, ranking, backend, threads, k, b)
+{
+    Trace::Span span("Engine::Engine");
+
     for (unsigned id = 0; id < info->lines; id++)
     {
         char word[512]; ifs >> word; // Consume Document ID
@@ -61,7 +112,7 @@ trie(info->lines), info(info), maxResults(maxResults), avgdl(0.0), k(k), b(b)
         info->documents[id][end] = '\0';
         do
         {
-            ifs >> word; trie.add(word, id); info->words[id]++;
+            ifs >> word; lexicon->add(word, id); info->words[id]++;
             
             std::strcat(info->documents[id], word);
             end += std::strlen(word);
@@ -76,22 +127,64 @@ trie(info->lines), info(info), maxResults(maxResults), avgdl(0.0), k(k), b(b)
                 break;
             }            
         } while (ifs.good());
+    }
 
+    finish(backend);
+}
+
+// Once the lexicon has been filled: average the document lengths,
+// freeze the lexicon if so requested and prepare the ranking function
+void Engine::finish(const Backend backend)
+{
+    double sum = 0.0;
+    for (unsigned id = 0; id < info->lines; id++)
         sum += (double) info->words[id];
-    }
 
     avgdl = sum / (double) info->lines;
+
+    if (backend == MPH || backend == LOUDS)
+    {
+        Trace::Span stage("freeze");
+
+        Lexicon * const frozen = lexicon->freeze();
+        if (frozen != lexicon)
+        {
+            delete lexicon;
+            lexicon = frozen;
+        }
+    }
+
+    switch (ranking)
+    {
+        case BM25:      prepare(BM25Rank(k, b));     break;
+        case BM25_PLUS: prepare(BM25PlusRank(k, b)); break;
+        case BM25L:     prepare(BM25LRank(k, b));    break;
+        case TFIDF:     prepare(TFIDFRank(k, b));    break;
+        default:        prepare(BM25Rank(k, b));     break; // Batches rank generic queries by BM25
+    }
 }
 
 Engine::~Engine()
 {
+    if (pool)
+        delete pool;
+
+    delete[] norms;
+    delete lexicon;
     delete info;
 }
 
 // Given a filename validate that the specified file
 // fulfill the requirements i.e. non negative document IDs, document IDs in order etc
-const Engine * Engine::validate(const char * filename, const unsigned maxResults, const double k, const double b)
+const Engine * Engine::validate(const char * filename, const unsigned maxResults, const Ranking ranking, const Backend backend, const unsigned threads, const double k, const double b)
 {
+    return load(filename, maxResults, ranking, backend, threads, k, b);
+}
+
+Engine * Engine::load(const char * filename, const unsigned maxResults, const Ranking ranking, const Backend backend, const unsigned threads, const double k, const double b)
+{
+    Trace::Span span("validate");
+
     // Check if the file has been opened successfully
     std::ifstream ifs(filename);
     if (!ifs.is_open())
@@ -110,51 +203,54 @@ const Engine * Engine::validate(const char * filename, const unsigned maxResults
     } * start = nullptr, ** current = &start;
 
     unsigned lines = 0;
-    int currentID, previousID = -1;
-    
-    char docID[512];
-    while (ifs >> docID)
+
+    // First pass: validate the document IDs and measure each document
     {
-        // Read each document's ID and confirm it' s valid
-        currentID = std::atoi(docID);
-        if (currentID != previousID + 1)
+        Trace::Span stage("validate.scan");
+
+        int previousID = -1;
+    
+        char docID[512];
+        while (ifs >> docID)
         {
-            std::cerr << Message[INVALID_ID_READ] << std::endl;
-            std::cerr << lines << "| " << docID << "..." << std::endl;
-            return nullptr;
-        }
+            // Read each document's ID and confirm it' s valid
+            if (!follows(docID, previousID, lines))
+            {
+                delete start;
+                return nullptr;
+            }
 
-        *current = new Util();
+            *current = new Util();
 
-        // Count the number of characters (non-consecutive whitespace)
-        char ch;
-        while (ifs.good())
-        {
-            if ((ch = (char) ifs.get()) == '\n')
-                break;
-            
-            (*current)->cols++;
-            if (std::isspace(ch))
+            // Count the number of characters (non-consecutive whitespace)
+            char ch;
+            while (ifs.good())
             {
-                while (ifs.good() && (ch = (char) ifs.peek()) != '\n' && std::isspace(ch))
-                    ifs.get();
+                if ((ch = (char) ifs.get()) == '\n')
+                    break;
             
-                if (ifs.eof() || (char) ifs.peek() == '\n')
-                    (*current)->cols--;
+                (*current)->cols++;
+                if (std::isspace(ch))
+                {
+                    while (ifs.good() && (ch = (char) ifs.peek()) != '\n' && std::isspace(ch))
+                        ifs.get();
+            
+                    if (ifs.eof() || (char) ifs.peek() == '\n')
+                        (*current)->cols--;
+                }
             }
-        }
 
-        // If any line (i.e. document) is completely blank fail
-        if (!(*current)->cols)
-        {
-            std::cerr << Message[EMPTY_DOC]  << " (" << currentID << ")" << std::endl;
-            return nullptr;
-        }
+            // If any line (i.e. document) is completely blank fail
+            if (!filled((*current)->cols, previousID))
+            {
+                delete start;
+                return nullptr;
+            }
 
-        lines++;
+            lines++;
 
-        previousID = currentID;
-        current = &(*current)->next;
+            current = &(*current)->next;
+        }
     }
 
     if (lines)
@@ -169,188 +265,1331 @@ const Engine * Engine::validate(const char * filename, const unsigned maxResults
         delete start;
         ifs.clear(); ifs.seekg(std::ios::beg);
 
-        return new Engine(ifs, info, (maxResults ? maxResults : 1), k, b);
+        return new Engine(ifs, info, (maxResults ? maxResults : 1), ranking, backend, threads, k, b);
     }
 
     return nullptr;
 }
 
-// Search Utility Functions:
-double Engine::score(const unsigned id, const unsigned qsize, const char * q[], const PList * l[]) const
+// Given a filename stream the specified file once, validating it the same way
+// as validate does, and build its index on disk within the given memory budget
+bool Engine::build(const char * filename, const char * prefix, const unsigned long budget)
 {
-    const double d_over_avgdl = (double) info->words[id] / avgdl;
-    
-    double sum = 0.0;
-    for (unsigned i = 0; i < qsize; i++)
+    std::ifstream ifs(filename);
+    if (!ifs.is_open())
     {
-        const double IDF = l[i]->IDF, fq = (double) l[i]->instances[id];
+        std::cerr << Message[CANNOT_OPEN_FILE] << std::endl;
+        return false;
+    }
 
-        sum += IDF * ((fq * (k + 1.0)) / (fq + k * (1.0 - b + b * d_over_avgdl)));
+    Index index(prefix, budget);
+    if (!index.good())
+    {
+        std::cerr << Message[CANNOT_WRITE_FILE] << std::endl;
+        return false;
     }
 
-    return sum;
+    unsigned lines = 0;
+    int previousID = -1;
+
+    char docID[512], word[512];
+    while (ifs >> docID)
+    {
+        // Read each document's ID and confirm it' s valid
+        if (!follows(docID, previousID, lines))
+            return false;
+
+        // Read each word of the document up to the end of the line
+        unsigned words = 0;
+        while (ifs.good())
+        {
+            char ch;
+            while ((ch = (char) ifs.get()) != '\n' && ifs.good() && std::isspace(ch));
+
+            if (ch == '\n' || !ifs.good())
+                break;
+
+            unsigned len = 0; int next;
+
+            word[len++] = ch;
+            while ((next = ifs.peek()) != EOF && !std::isspace(next))
+            {
+                ch = (char) ifs.get();
+                if (len < sizeof(word) - 1)
+                    word[len++] = ch;
+            }
+
+            word[len] = '\0';
+
+            if (!index.add(word, lines))
+            {
+                std::cerr << Message[CANNOT_WRITE_FILE] << std::endl;
+                return false;
+            }
+
+            words++;
+        }
+
+        // If any line (i.e. document) is completely blank fail
+        if (!filled(words, previousID))
+            return false;
+
+        if (!index.close())
+        {
+            std::cerr << Message[CANNOT_WRITE_FILE] << std::endl;
+            return false;
+        }
+
+        lines++;
+    }
+
+    if (lines && !index.finish())
+    {
+        std::cerr << Message[CANNOT_WRITE_FILE] << std::endl;
+        return false;
+    }
+
+    return lines;
 }
 
-bool Engine::parseInput(char * input, unsigned& qsize, const char * q[], const PList * l[]) const
+// Given the prefix of an index written by build (or pruneIndex) load its documents,
+// lexicon and postings, each term keeping the document frequency and IDF recorded in the lexicon
+const Engine * Engine::open(const char * prefix, const unsigned maxResults, const Ranking ranking, const Backend backend, const unsigned threads, const double k, const double b)
 {
-    const char del[] = " \t";
+    Trace::Span span("open");
 
-    unsigned i = 0;
-    
-    // If no input has been given fail
-    if (!(q[i] = std::strtok(input, del)))
+    char filename[512];
+
+    std::snprintf(filename, sizeof(filename), "%s.docs", prefix);
+    std::ifstream docs(filename);
+
+    std::snprintf(filename, sizeof(filename), "%s.lex", prefix);
+    std::ifstream lex(filename);
+
+    std::snprintf(filename, sizeof(filename), "%s.post", prefix);
+    std::ifstream post(filename, std::ios::binary);
+
+    if (!docs.is_open() || !lex.is_open() || !post.is_open())
     {
-        std::cerr << Message[NO_VALID_INPUT] << std::endl;
-        return false;
+        std::cerr << Message[CANNOT_OPEN_FILE] << std::endl;
+        return nullptr;
     }
-    
-    // Ignore (invalid) queries that cannot be found within the trie
-    // Get the Posting List of each valid query
-    do
+
+    // First pass: count the documents, none of which may be blank
+    unsigned lines = 0;
+    for (std::string line; std::getline(docs, line); lines++)
+        if (!filled(count(line.c_str()), (int) lines))
+            return nullptr;
+
+    if (!lines)
     {
-        if (l[i] = trie.lookup(q[i]))
-            i++;
-        else
-            std::cerr << Message[WORD_NOT_FOUND] << " (\"" << q[i] << "\")" << std::endl;
-    } while (i < maxQueries && (q[i] = std::strtok(nullptr, del)));
+        std::cerr << Message[INVALID_INDEX] << std::endl;
+        return nullptr;
+    }
 
-    // In case all the queries were invalid fail
-    if (i == 0)
+    Info * const info = new Info(lines);
+
+    docs.clear(); docs.seekg(std::ios::beg);
+
+    std::string line;
+    for (unsigned id = 0; id < lines; id++)
     {
-        std::cerr << Message[NO_VALID_INPUT] << std::endl;
-        return false;
+        std::getline(docs, line);
+
+        info->documents[id] = new char[info->columns[id] = (unsigned) line.size() + 1];
+        std::strcpy(info->documents[id], line.c_str());
+
+        info->words[id] = count(info->documents[id]);
     }
 
-    qsize = i;
-    return true;
+    Engine * const eng = new Engine(info, (maxResults ? maxResults : 1), ranking, backend, threads, k, b);
+    if (!eng->read(lex, post))
+    {
+        std::cerr << Message[INVALID_INDEX] << std::endl;
+        delete eng;
+        return nullptr;
+    }
+
+    eng->finish(backend);
+
+    return eng;
 }
 
-void Engine::printResult(const unsigned id, const double score, const unsigned i, const unsigned qsize, const char * q[]) const
+// Fill the lexicon from the "term documentNum documentFrequency IDF offset" lines and the postings they
+// point to, confirming that every term is unique and its postings valid and in order
+bool Engine::read(std::ifstream& lex, std::ifstream& post)
 {
-    const unsigned len = info->columns[id];
+    Trace::Span span("read");
 
-    // Initialize the padding
-    char * text[] = { new char[len], info->documents[id] };
+    unsigned * const ids = new unsigned[info->lines], * const frequencies = new unsigned[info->lines];
 
-    for (unsigned j = 0; j < len; j++)
-        text[0][j] = ' ';
+    char term[512];
+    unsigned documentNum, documentFrequency;
+    double IDF;
+    unsigned long offset;
 
-    // For each query locate every instance of it
-    // in the specified document (id) and underline it
-    for (unsigned j = 0; j < qsize; j++)
+    bool ok = true;
+    while (ok && lex >> std::setw(sizeof(term)) >> term >> documentNum >> documentFrequency >> IDF >> offset)
+    {
+        if (!documentNum || documentNum > documentFrequency || documentFrequency > info->lines || lexicon->lookup(term) ||
+            !post.seekg((std::streamoff) (offset * 2 * sizeof(unsigned))))
+        {
+            ok = false;
+            break;
+        }
+
+        for (unsigned i = 0; i < documentNum && ok; i++)
+        {
+            post.read((char *) &ids[i], sizeof(ids[i]));
+            post.read((char *) &frequencies[i], sizeof(frequencies[i]));
+
+            ok = (post.good() && ids[i] < info->lines && frequencies[i] && (!i || ids[i] > ids[i - 1]));
+        }
+
+        if (!ok)
+            break;
+
+        for (unsigned i = 0; i < documentNum; i++)
+            lexicon->add(term, ids[i]);
+
+        // The lexicon counted a single occurrence per posting
+        PList * const pl = const_cast<PList *>(lexicon->lookup(term));
+        for (unsigned i = 0; i < documentNum; i++)
+        {
+            pl->instances[ids[i]] = frequencies[i];
+            if (frequencies[i] > pl->maxFrequency)
+                pl->maxFrequency = frequencies[i];
+        }
+
+        pl->documentFrequency = documentFrequency;
+        pl->IDF = IDF;
+    }
+
+    delete[] frequencies;
+    delete[] ids;
+
+    // Every line should have been consumed
+    return (ok && lex.eof());
+}
+
+// Static Index Pruning Implementation:
+// The Posting Lists of the lexicon are owned (and were created) by it and
+// only handed out as const, hence the const_cast in order to shrink them
+template <typename Policy>
+void Engine::trim(const Policy& policy, const Pruning pruning, const double epsilon, const double maxDF)
+{
+    Trace::Span span("trim");
+
+    struct Gather
     {
-        const char * substr = std::strstr(info->documents[id], q[j]);
-        while (substr)
+        PList ** plists;
+        unsigned size, capacity;
+        unsigned long postings;
+
+        static void visit(const char *, const PList * plist, void * arg)
         {
-            const unsigned beg = (unsigned) (substr - info->documents[id]);
-            if (std::isspace(substr[std::strlen(q[j])]) && std::isspace(info->documents[id][beg - 1]))
+            Gather& gather = *(Gather *) arg;
+
+            if (gather.size == gather.capacity)
             {
-                const unsigned end = beg + std::strlen(q[j]) - 1;
-                for (unsigned k = beg; k <= end; k++)
-                    text[0][k] = '^';
+                PList ** const plists = new PList*[gather.capacity *= 2];
+                for (unsigned i = 0; i < gather.size; i++)
+                    plists[i] = gather.plists[i];
+
+                delete[] gather.plists;
+                gather.plists = plists;
             }
 
-            substr = std::strstr(++substr, q[j]);
+            gather.plists[gather.size++] = const_cast<PList *>(plist);
+            gather.postings += plist->documentNum;
         }
+    } gather = { new PList*[1024], 0, 1024, 0UL };
+
+    lexicon->visit(Gather::visit, &gather);
+
+    // Drop the terms of too high a document frequency (maxDF <= 0.5 drops
+    // every term of non-positive IDF) by dropping every one of their postings
+    for (unsigned t = 0; t < gather.size; t++)
+    {
+        PList * const pl = gather.plists[t];
+
+        if ((double) pl->documentNum >= maxDF * (double) info->lines)
+            for (unsigned i = 0; i < pl->documentNum; i++)
+                pl->instances[pl->documents[i]] = 0;
     }
 
-    // Print result info
-    const unsigned spaces = 23;
-    std::cout << std::setw(5) << i + 1 << '.'; // 6
-    std::cout << '(' << std::setw(5) << id << ')'; // 7
-    std::cout << '[' << std::setw(7) << std::setprecision(5) << std::showpos << score << "] " << std::noshowpos; // 10
+    if (pruning == TERM_CENTRIC)
+    {
+        double * const impact = new double[info->lines];
 
-    // Print Document and Padding
-    struct winsize w;
+        for (unsigned t = 0; t < gather.size; t++)
+        {
+            PList * const pl = gather.plists[t];
+            if (pl->documentNum <= maxResults || !pl->instances[pl->documents[0]])
+                continue;
 
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-    unsigned rowWidth = (len + spaces < w.ws_col ? len + spaces : w.ws_col), j = 0;
-    
-    // Print the first rowWidth - spaces characters of the document
-    // on the same line as the result info
-    for (unsigned l = 0; l < rowWidth - spaces; l++)
-        std::cout << text[1][l];
+            const double weight = policy.weight(pl, info->lines);
+            for (unsigned i = 0; i < pl->documentNum; i++)
+            {
+                const unsigned id = pl->documents[i];
+                impact[i] = std::fabs(policy.term(weight, (double) pl->instances[id], norms[id]));
+            }
 
-    std::cout << std::endl;
-    do
+            // The maxResults-th highest impact of the term
+            std::nth_element(impact, impact + maxResults - 1, impact + pl->documentNum, std::greater<double>());
+            const double threshold = epsilon * impact[maxResults - 1];
+
+            for (unsigned i = 0; i < pl->documentNum; i++)
+            {
+                const unsigned id = pl->documents[i];
+                if (std::fabs(policy.term(weight, (double) pl->instances[id], norms[id])) < threshold)
+                    pl->instances[id] = 0;
+            }
+        }
+
+        delete[] impact;
+    }
+    else
     {
-        // Print Padding
-        for (unsigned l = 0; l < spaces; l++)
-            std::cout << ' ';
-            
-        for (unsigned l = j; l < j + rowWidth - spaces && l < len; l++)
-            std::cout << text[0][l];
+        struct Posting
+        {
+            unsigned document, term;
+            double impact;
+
+            bool operator<(const Posting& other) const
+            {
+                return (document != other.document ? document < other.document : impact > other.impact);
+            }
+        } * const postings = new Posting[gather.postings ? gather.postings : 1];
+
+        unsigned long size = 0;
+        for (unsigned t = 0; t < gather.size; t++)
+        {
+            const PList * const pl = gather.plists[t];
+            const double weight = policy.weight(pl, info->lines);
 
-        std::cout << std::endl;
+            for (unsigned i = 0; i < pl->documentNum; i++)
+            {
+                const unsigned id = pl->documents[i];
+                if (!pl->instances[id])
+                    continue;
 
-        j += rowWidth - spaces;
+                postings[size].document = id;
+                postings[size].term = t;
+                postings[size++].impact = std::fabs(policy.term(weight, (double) pl->instances[id], norms[id]));
+            }
+        }
 
-        // Print Document
-        for (unsigned l = 0; l < spaces; l++)
-            std::cout << ' ';
-            
-        for (unsigned l = j; l < j + rowWidth - spaces && l < len; l++)
-            std::cout << text[1][l];
+        // Group the postings by document, most impactful first
+        std::sort(postings, postings + size);
 
-        std::cout << std::endl;
-    } while (j < len);
+        for (unsigned long i = 0, j; i < size; i = j)
+        {
+            for (j = i; j < size && postings[j].document == postings[i].document; j++);
+
+            const unsigned long keep = (unsigned long) std::ceil(epsilon * (double) (j - i));
+
+            for (unsigned long p = i + keep; p < j; p++)
+                gather.plists[postings[p].term]->instances[postings[p].document] = 0;
+        }
+
+        delete[] postings;
+    }
+
+    // Compact the Posting Lists, retaining their IDF and document frequency so that scores stay comparable
+    for (unsigned t = 0; t < gather.size; t++)
+    {
+        PList * const pl = gather.plists[t];
 
-    delete[] text[0];
+        unsigned kept = 0;
+        pl->maxFrequency = 0;
+        for (unsigned i = 0; i < pl->documentNum; i++)
+        {
+            const unsigned id = pl->documents[i];
+            if (!pl->instances[id])
+                continue;
+
+            pl->documents[kept++] = id;
+            if (pl->instances[id] > pl->maxFrequency)
+                pl->maxFrequency = pl->instances[id];
+        }
+
+        pl->documentNum = kept;
+    }
+
+    delete[] gather.plists;
 }
 
-// Search Engine Functionality:
-void Engine::search(char * input) const
+// Write the index in the format of build, the document frequency
+// and IDF of every term being those of the full index
+bool Engine::save(const char * prefix) const
 {
-    const char  * q[maxQueries] = { nullptr };
-    const PList * l[maxQueries] = { nullptr };
-    unsigned qsize;
-    
-    // Parse input in order to retrieve separate valid queries
-    // the corresponding Posting Lists
-    if (!parseInput(input, qsize, q, l))
-        return;
+    Index::Files files(prefix);
+    if (!files.good())
+        return false;
 
-    struct Pair
+    struct Writer
     {
-        unsigned id;
-        double score;
+        static void visit(const char * term, const PList * plist, void * arg)
+        {
+            Index::Files& files = *(Index::Files *) arg;
 
-        Pair() : id(0), score(0.0) {}
+            if (!plist->documentNum)
+                return;
 
-        bool operator>(const Pair& other) const { return (this->score > other.score); }
-    } pair;
+            for (unsigned i = 0; i < plist->documentNum; i++)
+                files.posting(plist->documents[i], plist->instances[plist->documents[i]]);
+
+            files.term(term, plist->documentFrequency, plist->IDF);
+        }
+    };
 
-    heap<Pair> pairs(info->lines, heap<Pair>::greater);
+    lexicon->visit(Writer::visit, &files);
 
-    // Insert <document, score> pairs into heap
-    // in order to find top maxResults documents
     for (unsigned id = 0; id < info->lines; id++)
     {
-        unsigned j;
-        for (j = 0; j < qsize; j++)
-            if (l[j]->instances[id])
-                break;
+        files.append(info->documents[id]);
+        files.close();
+    }
 
-        if (j < qsize)
-        {
-            pair.id = id;
-            pair.score = score(pair.id, qsize, q, l);
-            pairs.push(pair);
-        }
+    return files.finish();
+}
+
+bool Engine::pruneIndex(const char * filename, const char * prefix, const unsigned maxResults, const Pruning pruning, const double epsilon,
+                        const double maxDF, const Ranking ranking)
+{
+    Engine * const pruned = load(filename, maxResults, ranking, TRIE, 1, 1.2, 0.75);
+    if (!pruned)
+        return false;
+
+    switch (ranking)
+    {
+        case BM25_PLUS: pruned->trim(BM25PlusRank(pruned->k, pruned->b), pruning, epsilon, maxDF); break;
+        case BM25L:     pruned->trim(BM25LRank(pruned->k, pruned->b), pruning, epsilon, maxDF);    break;
+        case TFIDF:     pruned->trim(TFIDFRank(pruned->k, pruned->b), pruning, epsilon, maxDF);    break;
+        default:        pruned->trim(BM25Rank(pruned->k, pruned->b), pruning, epsilon, maxDF);     break;
     }
 
-    for (unsigned i = 0; i < maxResults && pairs.pop(pair); i++)
-        printResult(pair.id, pair.score, i, qsize, q);
+    const bool saved = pruned->save(prefix);
+    if (!saved)
+        std::cerr << Message[CANNOT_WRITE_FILE] << std::endl;
+
+    delete pruned;
+
+    return saved;
+}
+
+// Search Utility Functions:
+// Count the whitespace separated tokens of the input
+// and, optionally, how many of them are fuzzy (~term)
+unsigned Engine::count(const char * input, unsigned * fuzzy)
+{
+    unsigned tokens = 0;
+
+    if (fuzzy)
+        *fuzzy = 0;
+
+    for (bool inside = false; *input; input++)
+    {
+        const bool space = (*input == ' ' || *input == '\t');
+        if (!space && !inside)
+        {
+            tokens++;
+
+            if (fuzzy && *input == '~')
+                (*fuzzy)++;
+        }
+
+        inside = !space;
+    }
+
+    return tokens;
+}
+
+// The edit distance tolerated when matching the term
+unsigned Engine::tolerance(const char * term)
+{
+    return (std::strlen(term) <= 4 ? 1U : 2U);
+}
+
+double Engine::score(const unsigned id, const unsigned qsize, const char * q[], const PList * l[]) const
+{
+    const double d_over_avgdl = (double) info->words[id] / avgdl;
+    
+    double sum = 0.0;
+    for (unsigned i = 0; i < qsize; i++)
+    {
+        const double IDF = l[i]->IDF, fq = (double) l[i]->instances[id];
+
+        sum += IDF * ((fq * (k + 1.0)) / (fq + k * (1.0 - b + b * d_over_avgdl)));
+    }
+
+    return sum;
+}
+
+bool Engine::parseInput(char * input, unsigned& qsize, const char * q[], const PList * l[], Lexicon::Match matches[], const bool verbose) const
+{
+    Trace::Span span("parseInput");
+
+    const char del[] = " \t";
+
+    char * state;    // strtok_r keeps concurrent queries apart
+
+    unsigned i = 0;
+    
+    // If no input has been given fail
+    if (!(q[i] = strtok_r(input, del, &state)))
+    {
+        if (verbose)
+            std::cerr << Message[NO_VALID_INPUT] << std::endl;
+
+        return false;
+    }
+    
+    // Ignore (invalid) queries that cannot be found within the lexicon
+    // Get the Posting List of each valid query, expanding each
+    // fuzzy query (~term) to its closest terms
+    unsigned used = 0;
+    do
+    {
+        if (q[i][0] == '~' && q[i][1])
+        {
+            const char * const term = q[i] + 1;
+
+            Trace::Span stage("fuzzy");
+            const unsigned found = lexicon->fuzzy(term, tolerance(term), matches + used, maxExpansions);
+
+            if (!found && verbose)
+                std::cerr << Message[WORD_NOT_FOUND] << " (\"" << term << "\")" << std::endl;
+
+            for (unsigned j = 0; j < found; j++, i++, used++)
+            {
+                q[i] = matches[used].term;
+                l[i] = matches[used].plist;
+            }
+        }
+        else if (l[i] = lookup(q[i]))
+        {
+            i++;
+        }
+        else if (verbose)
+        {
+            std::cerr << Message[WORD_NOT_FOUND] << " (\"" << q[i] << "\")" << std::endl;
+            suggest(q[i]);
+        }
+    } while ((q[i] = strtok_r(nullptr, del, &state)));
+
+    // In case all the queries were invalid fail
+    if (i == 0)
+    {
+        if (verbose)
+            std::cerr << Message[NO_VALID_INPUT] << std::endl;
+
+        return false;
+    }
+
+    qsize = i;
+    return true;
+}
+
+const PList * Engine::lookup(const char * term) const
+{
+    Trace::Span span("lookup");
+
+    // Terms dropped by static pruning are left without any documents
+    const PList * const pl = lexicon->lookup(term);
+
+    return (pl && pl->documentNum ? pl : nullptr);
+}
+
+// Print the closest (then most frequent) terms within a small edit distance of the term
+void Engine::suggest(const char * term) const
+{
+    Trace::Span span("suggest");
+
+    Lexicon::Match matches[maxSuggestions];
+
+    const unsigned found = lexicon->fuzzy(term, tolerance(term), matches, maxSuggestions);
+    if (!found)
+        return;
+
+    std::cerr << Message[DID_YOU_MEAN] << ' ';
+    for (unsigned i = 0; i < found; i++)
+        std::cerr << (i ? ", \"" : "\"") << matches[i].term << '"';
+
+    std::cerr << '?' << std::endl;
+}
+
+// Pick (at most) the terms highest weighted terms of the text by tf * IDF
+unsigned Engine::select(char * text, const unsigned terms, const char * q[], const PList * l[]) const
+{
+    const char del[] = " \t";
+
+    struct Term
+    {
+        const char * word;
+        const PList * plist;
+        double weight;
+    } * const found = new Term[count(text) + 1];
+
+    char * state;
+
+    unsigned size = 0;
+    for (const char * word = strtok_r(text, del, &state); word; word = strtok_r(nullptr, del, &state))
+        if ((found[size].plist = lookup(word)))
+            found[size++].word = word;
+
+    // Group the occurrences of each term in order to determine its frequency
+    struct ByTerm
+    {
+        bool operator()(const Term& a, const Term& b) const { return std::less<const PList *>()(a.plist, b.plist); }
+    } byTerm;
+
+    std::sort(found, found + size, byTerm);
+
+    unsigned unique = 0;
+    for (unsigned i = 0, j; i < size; i = j)
+    {
+        for (j = i; j < size && found[j].plist == found[i].plist; j++);
+
+        // Terms of non-positive IDF cannot make any document more similar
+        if (found[i].plist->IDF > 0.0)
+        {
+            found[unique] = found[i];
+            found[unique++].weight = (double) (j - i) * found[i].plist->IDF;
+        }
+    }
+
+    struct ByWeight
+    {
+        bool operator()(const Term& a, const Term& b) const { return a.weight > b.weight; }
+    } byWeight;
+
+    const unsigned qsize = (unique < terms ? unique : terms);
+    std::partial_sort(found, found + qsize, found + unique, byWeight);
+
+    for (unsigned i = 0; i < qsize; i++)
+    {
+        q[i] = found[i].word;
+        l[i] = found[i].plist;
+    }
+
+    delete[] found;
+
+    return qsize;
+}
+
+// Precompute each document's length normalization under the given policy
+template <typename Policy>
+void Engine::prepare(const Policy& policy)
+{
+    Trace::Span span("prepare");
+
+    for (unsigned id = 0; id < info->lines; id++)
+        norms[id] = policy.norm(info->words[id], avgdl);
+}
+
+// Keep the top documents of a bounded heap (smallest score on top)
+void Engine::offer(heap<Result>& top, const Result& pair)
+{
+    Result min;
+    if (!top.push(pair) && top.peek(min) && pair > min)
+    {
+        top.pop(min);
+        top.push(pair);
+    }
+}
+
+// Offer the <document, score> pairs of the documents [lo, hi) to top
+template <typename Policy>
+void Engine::range(const Policy& policy, const unsigned qsize, const PList * l[], const double weight[], const unsigned lo, const unsigned hi, heap<Result>& top) const
+{
+    Result pair;
+    for (unsigned id = lo; id < hi; id++)
+    {
+        const double norm = norms[id];
+
+        bool found = false; double sum = 0.0;
+        for (unsigned j = 0; j < qsize; j++)
+        {
+            const unsigned fq = l[j]->instances[id];
+            if (fq)
+            {
+                sum += policy.term(weight[j], (double) fq, norm);
+                found = true;
+            }
+        }
+
+        if (found)
+        {
+            pair.id = id;
+            pair.score = sum;
+            offer(top, pair);
+        }
+    }
+}
+
+// Find the top limit documents; whenever the scan (documents x terms) outweighs
+// waking the pool, the document IDs are split into partitions scanned in parallel,
+// each keeping a top limit of its own, which are then merged
+template <typename Policy>
+unsigned Engine::rank(const Policy& policy, const unsigned qsize, const PList * l[], Result results[], const unsigned limit) const
+{
+    Trace::Span span("scan");
+
+    double * const weight = new double[qsize];
+    for (unsigned j = 0; j < qsize; j++)
+        weight[j] = policy.weight(l[j], info->lines);
+
+    unsigned i = 0;
+
+    if (pool && (unsigned long) info->lines * qsize >= parallelWork)
+    {
+        // Partitioning Implementation:
+        struct Partition
+        {
+            const Engine * engine;
+            const Policy * policy;
+            unsigned qsize;
+            const PList ** l;
+            const double * weight;
+
+            unsigned limit, documents;  // Documents per partition
+            Result * results;           // The top limit of each partition
+            unsigned * sizes;
+
+            static void run(void * arg, const unsigned p)
+            {
+                const Partition& part = *(const Partition *) arg;
+
+                const unsigned lines = part.engine->info->lines, lo = p * part.documents;
+                const unsigned hi = (lo + part.documents < lines ? lo + part.documents : lines);
+
+                heap<Result> top(part.limit, heap<Result>::less);
+                part.engine->range(*part.policy, part.qsize, part.l, part.weight, lo, hi, top);
+
+                unsigned n = 0;
+                for (; top.pop(part.results[p * part.limit + n]); n++);
+
+                part.sizes[p] = n;
+            }
+        } part;
+
+        // Several partitions per thread, so that there is work left to steal
+        const unsigned wanted = 4U * pool->size();
+
+        part.documents = (info->lines + wanted - 1) / wanted;
+        if (part.documents < minPartition)
+            part.documents = minPartition;
+
+        const unsigned partitions = (info->lines + part.documents - 1) / part.documents;
+
+        part.engine = this; part.policy = &policy; part.qsize = qsize; part.l = l; part.weight = weight;
+        part.limit = limit;
+        part.results = new Result[partitions * limit];
+        part.sizes = new unsigned[partitions];
+
+        // Another query may be holding the pool, in which case scan sequentially
+        if (partitions > 1 && pool->run(Partition::run, &part, partitions))
+        {
+            Trace::Span stage("select");
+
+            heap<Result> pairs(partitions * limit, heap<Result>::greater);
+            for (unsigned p = 0; p < partitions; p++)
+                for (unsigned n = 0; n < part.sizes[p]; n++)
+                    pairs.push(part.results[p * limit + n]);
+
+            for (; i < limit && pairs.pop(results[i]); i++);
+
+            delete[] part.sizes;
+            delete[] part.results;
+            delete[] weight;
+
+            return i;
+        }
+
+        delete[] part.sizes;
+        delete[] part.results;
+    }
+
+    heap<Result> top(limit, heap<Result>::less);
+    range(policy, qsize, l, weight, 0, info->lines, top);
+
+    delete[] weight;
+
+    Trace::Span stage("select");
+
+    // The top documents pop in increasing order of their score
+    for (; i < limit && top.pop(results[i]); i++);
+
+    std::reverse(results, results + i);
+
+    return i;
+}
+
+// The k-th largest accumulated score amongst the candidates (-infinity if fewer)
+static double kth(const double acc[], const unsigned candidates[], const unsigned size, const unsigned k)
+{
+    if (size < k)
+        return -HUGE_VAL;
+
+    heap<double> top(k + 1, heap<double>::less);
+
+    double min;
+    for (unsigned i = 0, pushed = 0; i < size; i++)
+        if (top.push(acc[candidates[i]]) && ++pushed > k)
+            top.pop(min), pushed--;
+
+    top.pop(min);
+
+    return min;
+}
+
+// Long queries are ranked term at a time (MaxScore): terms are processed in
+// decreasing order of their contribution bound and, as soon as the remaining
+// terms cannot lift an unseen document above the k-th score, no more candidates
+// are admitted. Each of the remaining terms then only updates, or drops, the
+// surviving candidates by random access, so that its cost depends on the
+// number of candidates rather than on the length of its posting list
+template <typename Policy>
+unsigned Engine::prune(const Policy& policy, const unsigned qsize, const PList * l[], Result results[], const unsigned limit) const
+{
+    Trace::Span span("prune");
+
+    struct Term
+    {
+        const PList * plist;
+        double weight, bound;
+
+        bool operator<(const Term& other) const { return this->bound > other.bound; }
+    } * const terms = new Term[qsize];
+
+    for (unsigned j = 0; j < qsize; j++)
+    {
+        terms[j].plist = l[j];
+        terms[j].weight = policy.weight(l[j], info->lines);
+        terms[j].bound = policy.bound(terms[j].weight, l[j]->maxFrequency);
+    }
+
+    std::sort(terms, terms + qsize);
+
+    // Upper (high) and lower (low) bound of the total contribution of terms j, j + 1, ...
+    double * const high = new double[qsize + 1], * const low = new double[qsize + 1];
+
+    high[qsize] = low[qsize] = 0.0;
+    for (unsigned j = qsize; j-- > 0; )
+    {
+        high[j] = high[j + 1] + (terms[j].weight > 0.0 ? terms[j].bound : 0.0);
+        low[j]  = low[j + 1]  - (terms[j].weight < 0.0 ? terms[j].bound : 0.0);
+    }
+
+    double * const acc = new double[info->lines];
+    bool * const seen = new bool[info->lines];
+    unsigned * const candidates = new unsigned[info->lines], size = 0;
+
+    for (unsigned id = 0; id < info->lines; id++)
+        seen[id] = false;
+
+    double threshold = -HUGE_VAL;
+
+    unsigned j = 0;
+    for (; j < qsize && (size < limit || high[j] >= threshold); j++)
+    {
+        const PList * const pl = terms[j].plist;
+
+        for (unsigned i = 0; i < pl->documentNum; i++)
+        {
+            const unsigned id = pl->documents[i];
+            if (!seen[id])
+            {
+                seen[id] = true;
+                acc[id] = 0.0;
+                candidates[size++] = id;
+            }
+
+            acc[id] += policy.term(terms[j].weight, (double) pl->instances[id], norms[id]);
+        }
+
+        threshold = kth(acc, candidates, size, limit) + low[j + 1];
+    }
+
+    for (; j < qsize; j++)
+    {
+        const PList * const pl = terms[j].plist;
+
+        unsigned alive = 0;
+        for (unsigned i = 0; i < size; i++)
+        {
+            const unsigned id = candidates[i];
+            if (acc[id] + high[j] < threshold)
+                continue;
+
+            const unsigned fq = pl->instances[id];
+            if (fq)
+                acc[id] += policy.term(terms[j].weight, (double) fq, norms[id]);
+
+            candidates[alive++] = id;
+        }
+
+        size = alive;
+        threshold = kth(acc, candidates, size, limit) + low[j + 1];
+    }
+
+    Trace::Span stage("select");
+
+    heap<Result> pairs(size, heap<Result>::greater);
+
+    Result pair;
+    for (unsigned i = 0; i < size; i++)
+    {
+        pair.id = candidates[i];
+        pair.score = acc[pair.id];
+        pairs.push(pair);
+    }
+
+    unsigned i = 0;
+    for (; i < limit && pairs.pop(results[i]); i++);
+
+    delete[] candidates;
+    delete[] seen;
+    delete[] acc;
+    delete[] low;
+    delete[] high;
+    delete[] terms;
+
+    return i;
+}
+
+// Dispatch to the instantiation of the engine's ranking function
+unsigned Engine::rank(const unsigned qsize, const char * q[], const PList * l[], Result results[], const unsigned limit) const
+{
+    switch (ranking)
+    {
+        case BM25:      return (qsize > longQuery ? prune(BM25Rank(k, b), qsize, l, results, limit)
+                                                  : rank(BM25Rank(k, b), qsize, l, results, limit));
+        case BM25_PLUS: return (qsize > longQuery ? prune(BM25PlusRank(k, b), qsize, l, results, limit)
+                                                  : rank(BM25PlusRank(k, b), qsize, l, results, limit));
+        case BM25L:     return (qsize > longQuery ? prune(BM25LRank(k, b), qsize, l, results, limit)
+                                                  : rank(BM25LRank(k, b), qsize, l, results, limit));
+        case TFIDF:     return (qsize > longQuery ? prune(TFIDFRank(k, b), qsize, l, results, limit)
+                                                  : rank(TFIDFRank(k, b), qsize, l, results, limit));
+        default:        break;
+    }
+
+    Trace::Span span("score");
+
+    Result pair;
+
+    heap<Result> pairs(info->lines, heap<Result>::greater);
+
+    for (unsigned id = 0; id < info->lines; id++)
+    {
+        unsigned j;
+        for (j = 0; j < qsize; j++)
+            if (l[j]->instances[id])
+                break;
+
+        if (j < qsize)
+        {
+            pair.id = id;
+            pair.score = score(pair.id, qsize, q, l);
+            pairs.push(pair);
+        }
+    }
+
+    Trace::Span stage("select");
+
+    unsigned i = 0;
+    for (; i < limit && pairs.pop(results[i]); i++);
+
+    return i;
+}
+
+// Shared scan: the Posting List of every distinct term of the batch is
+// decoded once and the contribution of each of its postings is computed
+// once and added to the accumulator of every query containing the term.
+// The documents are processed in chunks, so that the accumulators of the
+// whole batch stay small, and each query keeps its top maxResults documents
+template <typename Policy>
+void Engine::scan(const Policy& policy, Occurrence occurrences[], const unsigned size, const unsigned count, Result results[], unsigned sizes[]) const
+{
+    Trace::Span span("batch.scan");
+
+    struct ByPList
+    {
+        bool operator()(const Occurrence& a, const Occurrence& b) const { return std::less<const PList *>()(a.plist, b.plist); }
+    } byPList;
+
+    std::stable_sort(occurrences, occurrences + size, byPList);
+
+    // Group the occurrences of each distinct term
+    unsigned * const first = new unsigned[size + 1], groups = 0;
+    for (unsigned i = 0; i < size; i++)
+        if (!i || occurrences[i].plist != occurrences[i - 1].plist)
+            first[groups++] = i;
+
+    first[groups] = size;
+
+    double * const weight = new double[groups ? groups : 1];
+    unsigned * const cursor = new unsigned[groups ? groups : 1];
+    for (unsigned g = 0; g < groups; g++)
+    {
+        weight[g] = policy.weight(occurrences[first[g]].plist, info->lines);
+        cursor[g] = 0;
+    }
+
+    unsigned chunk = batchBudget / count;
+    if (chunk < 64U)
+        chunk = 64U;
+    if (chunk > info->lines)
+        chunk = info->lines;
+
+    double * const acc = new double[count * chunk];
+    bool * const seen = new bool[count * chunk];
+    unsigned * const touched = new unsigned[count * chunk], * const touchedNum = new unsigned[count];
+
+    for (unsigned i = 0; i < count * chunk; i++)
+        seen[i] = false;
+
+    heap<Result> ** const top = new heap<Result>*[count];
+    for (unsigned q = 0; q < count; q++)
+    {
+        top[q] = new heap<Result>(maxResults, heap<Result>::less);
+        touchedNum[q] = 0;
+    }
+
+    for (unsigned lo = 0; lo < info->lines; lo += chunk)
+    {
+        const unsigned hi = (lo + chunk < info->lines ? lo + chunk : info->lines);
+
+        for (unsigned g = 0; g < groups; g++)
+        {
+            const PList * const pl = occurrences[first[g]].plist;
+
+            for (unsigned id; cursor[g] < pl->documentNum && (id = pl->documents[cursor[g]]) < hi; cursor[g]++)
+            {
+                const double contribution = policy.term(weight[g], (double) pl->instances[id], norms[id]);
+
+                for (unsigned o = first[g]; o < first[g + 1]; o++)
+                {
+                    const unsigned q = occurrences[o].query, slot = q * chunk + id - lo;
+                    if (!seen[slot])
+                    {
+                        seen[slot] = true;
+                        acc[slot] = 0.0;
+                        touched[q * chunk + touchedNum[q]++] = id - lo;
+                    }
+
+                    acc[slot] += contribution;
+                }
+            }
+        }
+
+        // Offer the chunk's documents to the top maxResults of each query
+        for (unsigned q = 0; q < count; q++)
+        {
+            for (unsigned t = 0; t < touchedNum[q]; t++)
+            {
+                const unsigned slot = q * chunk + touched[q * chunk + t];
+
+                Result pair;
+                pair.id = lo + touched[q * chunk + t];
+                pair.score = acc[slot];
+
+                offer(*top[q], pair);
+
+                seen[slot] = false;
+            }
+
+            touchedNum[q] = 0;
+        }
+    }
+
+    // Each query's top documents pop in increasing order of their score
+    for (unsigned q = 0; q < count; q++)
+    {
+        Result * const rs = results + q * maxResults;
+
+        unsigned n = 0;
+        for (; n < maxResults && top[q]->pop(rs[n]); n++);
+
+        std::reverse(rs, rs + n);
+        sizes[q] = n;
+    }
+
+    for (unsigned q = 0; q < count; q++)
+        delete top[q];
+
+    delete[] top;
+    delete[] touchedNum;
+    delete[] touched;
+    delete[] seen;
+    delete[] acc;
+    delete[] cursor;
+    delete[] weight;
+    delete[] first;
+}
+
+// Search Engine Functionality:
+void Engine::search(char * input, Renderer& renderer) const
+{
+    Trace::Span span("search");
+
+    unsigned fuzzy;
+    const unsigned tokens = count(input, &fuzzy) + fuzzy * (maxExpansions - 1) + 1;
+
+    const char  ** const q = new const char*[tokens];
+    const PList ** const l = new const PList*[tokens];
+    Lexicon::Match * const matches = new Lexicon::Match[fuzzy * maxExpansions];
+    unsigned qsize;
+    
+    // Parse input in order to retrieve separate valid queries
+    // the corresponding Posting Lists
+    if (parseInput(input, qsize, q, l, matches, true))
+    {
+        Result * const results = new Result[maxResults];
+
+        const unsigned size = rank(qsize, q, l, results, maxResults);
+
+        renderer.begin();
+        for (unsigned i = 0; i < size; i++)
+            renderer.result(i, results[i].id, results[i].score, info->documents[results[i].id], qsize, q);
+
+        renderer.flush();
+
+        delete[] results;
+    }
+
+    delete[] matches;
+    delete[] l;
+    delete[] q;
+}
+
+// Same as search but, instead of printing them, store the top
+// maxResults documents in results and return their number
+unsigned Engine::query(char * input, Result results[]) const
+{
+    Trace::Span span("query");
+
+    unsigned fuzzy;
+    const unsigned tokens = count(input, &fuzzy) + fuzzy * (maxExpansions - 1) + 1;
+
+    const char  ** const q = new const char*[tokens];
+    const PList ** const l = new const PList*[tokens];
+    Lexicon::Match * const matches = new Lexicon::Match[fuzzy * maxExpansions];
+    unsigned qsize, size = 0;
+
+    if (parseInput(input, qsize, q, l, matches, false))
+        size = rank(qsize, q, l, results, maxResults);
+
+    delete[] matches;
+    delete[] l;
+    delete[] q;
+
+    return size;
+}
+
+// Same as query for each of the inputs, sharing the scan of the terms
+// they have in common; the results of the i-th input are stored starting
+// at results[i * maxResults] and their number in sizes[i]
+unsigned Engine::batch(char * inputs[], const unsigned queries, Result results[], unsigned sizes[]) const
+{
+    Trace::Span span("batch");
+
+    unsigned * const tokens = new unsigned[queries], total = 0;
+    unsigned * const fuzzy = new unsigned[queries];
+    for (unsigned i = 0; i < queries; i++)
+    {
+        tokens[i] = count(inputs[i], &fuzzy[i]) + fuzzy[i] * (maxExpansions - 1) + 1;
+        total += tokens[i];
+    }
+
+    // Gather the Posting List of every valid term of every query
+    Occurrence * const occurrences = new Occurrence[total ? total : 1];
+    unsigned size = 0, valid = 0;
+
+    for (unsigned i = 0; i < queries; i++)
+    {
+        const char  ** const q = new const char*[tokens[i]];
+        const PList ** const l = new const PList*[tokens[i]];
+        Lexicon::Match * const matches = new Lexicon::Match[fuzzy[i] * maxExpansions];
+        unsigned qsize;
+
+        if (parseInput(inputs[i], qsize, q, l, matches, false))
+        {
+            for (unsigned j = 0; j < qsize; j++, size++)
+            {
+                occurrences[size].plist = l[j];
+                occurrences[size].query = i;
+            }
+
+            valid++;
+        }
+
+        delete[] matches;
+        delete[] l;
+        delete[] q;
+    }
+
+    if (queries)
+    {
+        switch (ranking)
+        {
+            case BM25_PLUS: scan(BM25PlusRank(k, b), occurrences, size, queries, results, sizes); break;
+            case BM25L:     scan(BM25LRank(k, b), occurrences, size, queries, results, sizes);    break;
+            case TFIDF:     scan(TFIDFRank(k, b), occurrences, size, queries, results, sizes);    break;
+            default:        scan(BM25Rank(k, b), occurrences, size, queries, results, sizes);     break;
+        }
+    }
+
+    delete[] occurrences;
+    delete[] fuzzy;
+    delete[] tokens;
+
+    return valid;
+}
+
+// Run the queries of the file (one per line) as a single batch
+// and print the top documents of each
+void Engine::batch(const char * filename) const
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open())
+    {
+        std::cerr << Message[CANNOT_OPEN_FILE] << std::endl;
+        return;
+    }
+
+    unsigned lines = 0;
+    for (std::string line; std::getline(ifs, line); lines++);
+
+    char ** const inputs = new char*[lines ? lines : 1];
+    char ** const texts = new char*[lines ? lines : 1];
+
+    ifs.clear(); ifs.seekg(std::ios::beg);
+
+    unsigned count = 0;
+    for (std::string line; count < lines && std::getline(ifs, line); count++)
+    {
+        inputs[count] = new char[line.size() + 1];
+        texts[count] = new char[line.size() + 1];
+
+        std::strcpy(inputs[count], line.c_str());
+        std::strcpy(texts[count], line.c_str());
+    }
+
+    Result * const results = new Result[(count ? count : 1) * maxResults];
+    unsigned * const sizes = new unsigned[count ? count : 1];
+
+    batch(inputs, count, results, sizes);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        std::cout << std::setw(5) << i + 1 << ". " << texts[i] << std::endl;
+
+        if (!sizes[i])
+            std::cerr << Message[NO_VALID_INPUT] << std::endl;
+
+        for (unsigned j = 0; j < sizes[i]; j++)
+        {
+            const Result& result = results[i * maxResults + j];
+
+            std::cout << std::setw(10) << j + 1 << '.' << '(' << std::setw(5) << result.id << ')'
+                      << '[' << std::setw(7) << std::setprecision(5) << std::showpos << result.score << ']' << std::noshowpos << std::endl;
+        }
+
+        delete[] texts[i];
+        delete[] inputs[i];
+    }
+
+    delete[] sizes;
+    delete[] results;
+    delete[] texts;
+    delete[] inputs;
+}
+
+// "More like this": search using the terms highest weighted terms
+// of the specified document (id), excluding the document itself
+void Engine::similar(const int id, const unsigned terms, Renderer& renderer) const
+{
+    if (id < 0 || (unsigned) id > info->lines - 1)
+    {
+        std::cerr << Message[ID_OUT_OF_RANGE] << std::endl;
+        return;
+    }
+
+    char * const text = new char[info->columns[id] + 1];
+    std::strcpy(text, info->documents[id]);
+
+    const unsigned tokens = count(text) + 1;
+
+    const char  ** const q = new const char*[tokens];
+    const PList ** const l = new const PList*[tokens];
+
+    const unsigned qsize = select(text, terms, q, l);
+    if (qsize)
+    {
+        Result * const results = new Result[maxResults + 1];
+
+        const unsigned size = rank(qsize, q, l, results, maxResults + 1);
+
+        renderer.begin();
+        for (unsigned i = 0, j = 0; i < size && j < maxResults; i++)
+            if (results[i].id != (unsigned) id)
+                renderer.result(j++, results[i].id, results[i].score, info->documents[results[i].id], qsize, q);
+
+        renderer.flush();
+
+        delete[] results;
+    }
+    else
+    {
+        std::cerr << Message[NO_VALID_INPUT] << std::endl;
+    }
+
+    delete[] l;
+    delete[] q;
+    delete[] text;
+}
+
+// Same as similar but for arbitrary (long) text, storing the top
+// maxResults documents in results and returning their number
+unsigned Engine::similar(const char * input, const unsigned terms, Result results[]) const
+{
+    char * const text = new char[std::strlen(input) + 1];
+    std::strcpy(text, input);
+
+    const unsigned tokens = count(text) + 1;
+
+    const char  ** const q = new const char*[tokens];
+    const PList ** const l = new const PList*[tokens];
+
+    const unsigned qsize = select(text, terms, q, l);
+    const unsigned size = (qsize ? rank(qsize, q, l, results, maxResults) : 0);
+
+    delete[] l;
+    delete[] q;
+    delete[] text;
+
+    return size;
+}
+
+void Engine::docfreq(const char * prefix) const
+{
+    if (prefix)
+        lexicon->print(prefix);
+    else
+        lexicon->print();
 }
 
-void Engine::docfreq() const
+void Engine::vocabulary(Lexicon::Visitor visitor, void * arg) const
 {
-    trie.print();
+    lexicon->visit(visitor, arg);
 }
 
 void Engine::trmfreq(const int id, const char * word) const
 {
-    const PList * const pl = trie.lookup(word);
+    const PList * const pl = lexicon->lookup(word);
 
     if (pl)
         if (0 <= id && (unsigned) id <= info->lines - 1)
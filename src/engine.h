@@ -3,14 +3,69 @@
 #ifndef __ENGINE__
 #define __ENGINE__
 
-#include "trie.h"
+#include "lexicon.h"
 #include <iosfwd>
 
+template <typename T>
+class heap;
+
+class Pool;
+class Renderer;
+
 class Engine
 {
-    static const unsigned maxQueries;
+public:
+
+    // Ranking functions (see ranking.h), GENERIC being the original,
+    // runtime parameterized BM25 implementation
+    enum Ranking {
+        GENERIC,
+        BM25,
+        BM25_PLUS,
+        BM25L,
+        TFIDF
+    };
+
+    // Static index pruning: TERM_CENTRIC drops the postings of each term that score
+    // less than epsilon times its maxResults-th highest score, DOCUMENT_CENTRIC keeps
+    // (at most) the epsilon fraction of each document's terms that score highest
+    enum Pruning {
+        TERM_CENTRIC,
+        DOCUMENT_CENTRIC
+    };
+
+    // Lexicon backends: a sorted trie, a Robin Hood hash table, the latter frozen
+    // into a minimal perfect hash table or the former frozen into a LOUDS trie
+    enum Backend {
+        TRIE,
+        HASH,
+        MPH,
+        LOUDS
+    };
+
+    struct Result
+    {
+        unsigned id;
+        double score;
+
+        Result() : id(0), score(0.0) {}
+
+        // Ties are broken by ID, the lower ranking higher, so that the order
+        // of the results does not depend on how the documents were scanned
+        bool operator>(const Result& other) const { return (this->score > other.score || (this->score == other.score && this->id < other.id)); }
+        bool operator<(const Result& other) const { return (this->score < other.score || (this->score == other.score && this->id > other.id)); }
+    };
+
+private:
+
+    static const unsigned longQuery;    // Queries of more terms are ranked with pruning
+    static const unsigned maxExpansions; // Terms a fuzzy query term (~term) expands to
+    static const unsigned maxSuggestions;
+    static const unsigned batchBudget;  // Accumulators shared by the queries of a batch
+    static const unsigned long parallelWork; // Documents x terms worth a parallel scan
+    static const unsigned minPartition; // Documents per partition of a parallel scan
     
-    Trie trie;
+    Lexicon * lexicon;
     
     // File Info Implementation:
     struct Info
@@ -28,12 +83,55 @@ class Engine
     double avgdl;
     const double k, b;
 
-    Engine(std::ifstream&, const Info *, const unsigned, const double, const double);
+    const Ranking ranking;
+    double * norms;             // Each documents' length normalization under ranking
+
+    Pool * const pool;          // Scans the partitions of a query (nullptr if single threaded)
+
+    // A query term of a batch
+    struct Occurrence
+    {
+        const PList * plist;
+        unsigned query;
+    };
+
+    Engine(const Info *, const unsigned, const Ranking, const Backend, const unsigned, const double, const double);
+    Engine(std::ifstream&, const Info *, const unsigned, const Ranking, const Backend, const unsigned, const double, const double);
+
+    void finish(const Backend);
+    bool read(std::ifstream&, std::ifstream&);
+
+    static Engine * load(const char *, const unsigned, const Ranking, const Backend, const unsigned, const double, const double);
 
     // Search Utility Functions:
+    static unsigned count(const char *, unsigned * fuzzy = nullptr);
+    static unsigned tolerance(const char *);
+
     double score(const unsigned, const unsigned, const char * [], const PList * []) const;
-    bool parseInput(char *, unsigned&, const char * [], const PList * []) const;
-    void printResult(const unsigned, const double, const unsigned, const unsigned, const char * []) const;
+    const PList * lookup(const char *) const;
+    bool parseInput(char *, unsigned&, const char * [], const PList * [], Lexicon::Match [], const bool) const;
+    void suggest(const char *) const;
+    unsigned select(char *, const unsigned, const char * [], const PList * []) const;
+
+    template <typename Policy>
+    void prepare(const Policy&);
+
+    static void offer(heap<Result>&, const Result&);
+
+    template <typename Policy>
+    void range(const Policy&, const unsigned, const PList * [], const double [], const unsigned, const unsigned, heap<Result>&) const;
+    template <typename Policy>
+    unsigned rank(const Policy&, const unsigned, const PList * [], Result [], const unsigned) const;
+    template <typename Policy>
+    unsigned prune(const Policy&, const unsigned, const PList * [], Result [], const unsigned) const;
+    unsigned rank(const unsigned, const char * [], const PList * [], Result [], const unsigned) const;
+    template <typename Policy>
+    void scan(const Policy&, Occurrence [], const unsigned, const unsigned, Result [], unsigned []) const;
+
+    // Static Index Pruning Utility Functions:
+    template <typename Policy>
+    void trim(const Policy&, const Pruning, const double, const double);
+    bool save(const char *) const;
 
 public:
     
@@ -44,17 +142,41 @@ public:
         ID_OUT_OF_RANGE,
         WORD_NOT_FOUND,
         NO_VALID_INPUT,
-        EMPTY_DOC
+        EMPTY_DOC,
+        CANNOT_WRITE_FILE,
+        INVALID_INDEX,
+        DID_YOU_MEAN
     };
 
     ~Engine();
 
-    static const Engine * validate(const char *, const unsigned, const double k = 1.2, const double b = 0.75);
+    static const Engine * validate(const char *, const unsigned, const Ranking ranking = BM25, const Backend backend = TRIE,
+                                   const unsigned threads = 1, const double k = 1.2, const double b = 0.75);
+
+    // External-memory Index Build:
+    static bool build(const char *, const char *, const unsigned long);
+
+    // Load an index written by build (or pruneIndex) given its prefix
+    static const Engine * open(const char *, const unsigned, const Ranking ranking = BM25, const Backend backend = TRIE,
+                               const unsigned threads = 1, const double k = 1.2, const double b = 0.75);
+
+    // Static Index Pruning: write the pruned index in the format of build,
+    // dropping the terms of document frequency at least maxDF * N as well
+    static bool pruneIndex(const char *, const char *, const unsigned, const Pruning, const double, const double maxDF = 2.0,
+                           const Ranking ranking = BM25);
 
     // Search Engine Functionality:
-    void search(char *) const;
-    void docfreq() const;
+    void search(char *, Renderer&) const;
+    unsigned query(char *, Result []) const;
+    unsigned batch(char * [], const unsigned, Result [], unsigned []) const;
+    void batch(const char *) const;
+    void similar(const int, const unsigned, Renderer&) const;
+    unsigned similar(const char *, const unsigned, Result []) const;
+    void docfreq(const char * prefix = nullptr) const;
     void trmfreq(const int, const char *) const;
+
+    // Visit every (term, Posting List) pair of the lexicon
+    void vocabulary(Lexicon::Visitor, void *) const;
 };
 
 #endif
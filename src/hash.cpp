@@ -0,0 +1,403 @@
+/* C++ Hash Table (Inverted Index) implementation by Vasileios Sioros */
+
+#include "hash.h"
+#include <algorithm>
+#include <cstring>
+
+// Slot Implementation:
+Hash::Slot::Slot()
+:
+term(nullptr), plist(nullptr), hash(0), distance(0)
+{
+}
+
+// Interned Terms Implementation:
+const unsigned Hash::Block::size = 1U << 16;
+
+Hash::Block::Block(Block * next)
+:
+data(new char[size]), used(0), next(next)
+{
+}
+
+Hash::Block::~Block()
+{
+    delete[] data;
+
+    if (next)
+        delete next;
+}
+
+// Hash Implementation:
+// 64 bit FNV-1a followed by MurmurHash3's finalizer
+unsigned long Hash::hash(const char * term)
+{
+    unsigned long h = 0xcbf29ce484222325UL;
+
+    for (; *term; term++)
+    {
+        h ^= (unsigned char) *term;
+        h *= 0x100000001b3UL;
+    }
+
+    return mix(h, 0);
+}
+
+// Derive a hash function per seed from a single pass over the term
+unsigned long Hash::mix(unsigned long h, const unsigned long seed)
+{
+    h ^= seed * 0x9e3779b97f4a7c15UL;
+
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdUL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53UL;
+    h ^= h >> 33;
+
+    return h;
+}
+
+Hash::Hash(const unsigned total)
+:
+Lexicon(total), blocks(nullptr), slots(new Slot[16]), capacity(16), size(0), seeds(nullptr), buckets(0),
+sorted(nullptr), longest(0)
+{
+}
+
+Hash::~Hash()
+{
+    for (unsigned i = 0; i < capacity; i++)
+        if (slots[i].term)
+            destroy(slots[i].plist);
+
+    delete[] slots;
+    delete[] seeds;
+    delete[] sorted;
+
+    if (blocks)
+        delete blocks;
+}
+
+const char * Hash::intern(const char * term)
+{
+    const unsigned len = (unsigned) std::strlen(term) + 1;
+
+    if (!blocks || blocks->used + len > Block::size)
+        blocks = new Block(blocks);
+
+    char * const copy = blocks->data + blocks->used;
+    std::memcpy(copy, term, len);
+    blocks->used += len;
+
+    if (len - 1 > longest)
+        longest = len - 1;
+
+    return copy;
+}
+
+// Robin Hood insertion: whenever the probed entry is closer to its home
+// slot than the entry being inserted, swap them and carry on with the former
+void Hash::insert(Slot slot)
+{
+    const unsigned mask = capacity - 1;
+
+    slot.distance = 0;
+    for (unsigned i = slot.hash & mask; ; i = (i + 1) & mask, slot.distance++)
+    {
+        if (!slots[i].term)
+        {
+            slots[i] = slot;
+            return;
+        }
+
+        if (slots[i].distance < slot.distance)
+            std::swap(slots[i], slot);
+    }
+}
+
+// Double the capacity once the load factor exceeds 7/8
+void Hash::grow()
+{
+    Slot * const old = slots;
+    const unsigned oldCapacity = capacity;
+
+    slots = new Slot[capacity *= 2];
+
+    for (unsigned i = 0; i < oldCapacity; i++)
+        if (old[i].term)
+            insert(old[i]);
+
+    delete[] old;
+}
+
+void Hash::add(const char * string, const unsigned documentId)
+{
+    // A frozen table is read-only
+    if (seeds)
+        return;
+
+    PList * plist = const_cast<PList *>(lookup(string));
+
+    if (!plist)
+    {
+        if (8 * (size + 1) > 7 * capacity)
+            grow();
+
+        Slot slot;
+        slot.term = intern(string);
+        slot.plist = plist = create();
+        slot.hash = (unsigned) hash(string);
+
+        insert(slot); size++;
+    }
+
+    update(plist, documentId);
+}
+
+const PList * Hash::lookup(const char * string) const
+{
+    if (seeds)
+    {
+        if (!size)
+            return nullptr;
+
+        const unsigned long h = hash(string);
+        const Slot& slot = slots[mix(h, seeds[h % buckets]) % size];
+
+        return (!std::strcmp(slot.term, string) ? slot.plist : nullptr);
+    }
+
+    const unsigned mask = capacity - 1, h = (unsigned) hash(string);
+
+    // Stop as soon as the probed entry is closer to its home slot than
+    // the term would be, as Robin Hood insertion would have placed it there
+    unsigned distance = 0;
+    for (unsigned i = h & mask; slots[i].term && slots[i].distance >= distance; i = (i + 1) & mask, distance++)
+        if (slots[i].hash == h && !std::strcmp(slots[i].term, string))
+            return slots[i].plist;
+
+    return nullptr;
+}
+
+// Visit the terms in lexicographic order
+void Hash::visit(Visitor visitor, void * arg) const
+{
+    if (sorted)
+    {
+        for (unsigned i = 0; i < size; i++)
+            visitor(slots[sorted[i]].term, slots[sorted[i]].plist, arg);
+
+        return;
+    }
+
+    const Slot ** const order = new const Slot*[size];
+
+    unsigned count = 0;
+    for (unsigned i = 0; i < capacity; i++)
+        if (slots[i].term)
+            order[count++] = &slots[i];
+
+    struct Order
+    {
+        bool operator()(const Slot * a, const Slot * b) const { return std::strcmp(a->term, b->term) < 0; }
+    } byTerm;
+
+    std::sort(order, order + count, byTerm);
+
+    for (unsigned i = 0; i < count; i++)
+        visitor(order[i]->term, order[i]->plist, arg);
+
+    delete[] order;
+}
+
+// Run the Levenshtein automaton on the terms in turn (in lexicographic order once
+// frozen, in slot order otherwise) keeping a row per depth, so that each term resumes
+// from the prefix it shares with the previous one and the terms extending a prefix
+// which has already been ruled out are skipped altogether
+unsigned Hash::fuzzy(const char * term, const unsigned distance, Match matches[], const unsigned max) const
+{
+    const unsigned len = (unsigned) std::strlen(term);
+
+    unsigned * const rows = new unsigned[(longest + 1) * (len + 1)];
+    for (unsigned i = 0; i <= len; i++)
+        rows[i] = i;
+
+    const char * previous = "";
+    unsigned computed = 0;      // Letters of the previous term whose rows are computed
+    bool failed = false;        // Whether the last of them ruled the previous term out
+
+    unsigned found = 0;
+    for (unsigned i = 0, n = 0; n < size; i++)
+    {
+        const Slot& slot = slots[sorted ? sorted[i] : i];
+        if (!slot.term)
+            continue;
+
+        n++;
+
+        const char * const word = slot.term;
+
+        unsigned common = 0;
+        for (; common < computed && word[common] == previous[common]; common++);
+
+        if (failed && common == computed)
+            continue;
+
+        unsigned j = common;
+        for (failed = false; word[j]; j++)
+            if (advance(rows + j * (len + 1), rows + (j + 1) * (len + 1), term, len, word[j]) > distance)
+            {
+                failed = true;
+                j++;
+                break;
+            }
+
+        previous = word;
+        computed = j;
+
+        if (!failed && rows[j * (len + 1) + len] <= distance)
+            offer(matches, found, max, word, slot.plist, rows[j * (len + 1) + len]);
+    }
+
+    delete[] rows;
+
+    return found;
+}
+
+// Hash and displace: the terms are grouped into buckets by their hash,
+// then, largest bucket first, each bucket is assigned the first seed
+// that maps all of its terms to distinct, still free slots
+Lexicon * Hash::freeze()
+{
+    if (seeds)
+        return this;
+
+    buckets = size / 4 + 1;
+    seeds = new unsigned[buckets];
+
+    // Group the terms by bucket (counting sort)
+    unsigned * const start = new unsigned[buckets + 1];
+    for (unsigned b = 0; b <= buckets; b++)
+        start[b] = 0;
+
+    for (unsigned i = 0; i < capacity; i++)
+        if (slots[i].term)
+            start[hash(slots[i].term) % buckets + 1]++;
+
+    unsigned largest = 0;
+    for (unsigned b = 0; b < buckets; b++)
+    {
+        largest = std::max(largest, start[b + 1]);
+        start[b + 1] += start[b];
+    }
+
+    const Slot ** const grouped = new const Slot*[size ? size : 1];
+    unsigned long * const hashes = new unsigned long[size ? size : 1];
+    unsigned * const fill = new unsigned[buckets];
+    for (unsigned b = 0; b < buckets; b++)
+        fill[b] = start[b];
+
+    for (unsigned i = 0; i < capacity; i++)
+        if (slots[i].term)
+        {
+            const unsigned long h = hash(slots[i].term);
+
+            hashes[fill[h % buckets]] = h;
+            grouped[fill[h % buckets]++] = &slots[i];
+        }
+
+    // Order the buckets by decreasing size
+    unsigned * const order = new unsigned[buckets];
+    for (unsigned b = 0; b < buckets; b++)
+        order[b] = b;
+
+    struct Larger
+    {
+        const unsigned * start;
+
+        bool operator()(const unsigned a, const unsigned b) const
+        {
+            return start[a + 1] - start[a] > start[b + 1] - start[b];
+        }
+    } larger = { start };
+
+    std::sort(order, order + buckets, larger);
+
+    Slot * const table = new Slot[size ? size : 1];
+    bool * const taken = new bool[size ? size : 1];
+    for (unsigned i = 0; i < size; i++)
+        taken[i] = false;
+
+    unsigned * const position = new unsigned[largest ? largest : 1];
+
+    for (unsigned o = 0; o < buckets; o++)
+    {
+        const unsigned b = order[o], first = start[b], count = start[b + 1] - start[b];
+
+        seeds[b] = 0;
+        if (!count)
+            continue;
+
+        for (unsigned seed = 1; ; seed++)
+        {
+            unsigned j = 0;
+            for (; j < count; j++)
+            {
+                position[j] = (unsigned) (mix(hashes[first + j], seed) % size);
+
+                if (taken[position[j]] || std::find(position, position + j, position[j]) != position + j)
+                    break;
+            }
+
+            if (j == count)
+            {
+                seeds[b] = seed;
+                break;
+            }
+        }
+
+        for (unsigned j = 0; j < count; j++)
+        {
+            table[position[j]] = *grouped[first + j];
+            taken[position[j]] = true;
+        }
+    }
+
+    delete[] position;
+    delete[] taken;
+    delete[] order;
+    delete[] fill;
+    delete[] hashes;
+    delete[] grouped;
+    delete[] start;
+
+    delete[] slots;
+
+    slots = table;
+    capacity = size;
+
+    // Lexicographic order, for visiting and fuzzy matching without sorting every time
+    sorted = new unsigned[size ? size : 1];
+    for (unsigned i = 0; i < size; i++)
+        sorted[i] = i;
+
+    struct Order
+    {
+        const Slot * slots;
+
+        bool operator()(const unsigned a, const unsigned b) const { return std::strcmp(slots[a].term, slots[b].term) < 0; }
+    } byTerm = { slots };
+
+    std::sort(sorted, sorted + size, byTerm);
+
+    return this;
+}
+
+unsigned long Hash::bytes() const
+{
+    unsigned long total = sizeof(*this) + capacity * sizeof(Slot) + buckets * sizeof(unsigned)
+                        + (sorted ? size * sizeof(unsigned) : 0UL);
+
+    for (const Block * block = blocks; block; block = block->next)
+        total += sizeof(Block) + Block::size;
+
+    return total;
+}
@@ -0,0 +1,70 @@
+/* C++ Hash Table (Inverted Index) implementation by Vasileios Sioros */
+
+#ifndef __HASH__
+#define __HASH__
+
+#include "lexicon.h"
+
+// Open addressing hash table of interned terms, using Robin Hood hashing
+// i.e. on collision the entry furthest from its home slot keeps the slot,
+// which bounds the probe sequence of lookups
+//
+// Once frozen, the table is rebuilt as a minimal perfect hash function
+// (hash and displace) so that every lookup probes exactly one slot
+class Hash : public Lexicon
+{
+    // Slot Implementation:
+    struct Slot
+    {
+        const char * term;      // Interned term (nullptr if the slot is empty)
+        PList * plist;
+        unsigned hash;          // Cached hash of the term
+        unsigned distance;      // Distance from the term's home slot
+
+        Slot();
+    };
+
+    // Interned Terms Implementation:
+    struct Block
+    {
+        static const unsigned size;
+
+        char * const data;
+        unsigned used;
+        Block * const next;
+
+        Block(Block *);
+        ~Block();
+    } * blocks;
+
+    static unsigned long hash(const char *);
+    static unsigned long mix(unsigned long, const unsigned long);
+
+    Slot * slots;
+    unsigned capacity, size;    // Capacity is a power of 2, unless frozen
+
+    unsigned * seeds;           // Displacement seed of every bucket (frozen)
+    unsigned buckets;
+
+    unsigned * sorted;          // Slots in lexicographic order of their terms (frozen)
+    unsigned longest;           // Length of the longest term
+
+    const char * intern(const char *);
+    void insert(Slot);
+    void grow();
+
+public:
+
+    Hash(const unsigned);
+    ~Hash();
+
+    void add(const char *, const unsigned);
+    const PList * lookup(const char *) const;
+    void visit(Visitor, void *) const;
+    unsigned fuzzy(const char *, const unsigned, Match [], const unsigned) const;
+
+    Lexicon * freeze();
+    unsigned long bytes() const;
+};
+
+#endif
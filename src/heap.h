@@ -21,6 +21,7 @@ public:
 
     bool push(const T&);
     bool pop(T&);
+    bool peek(T&) const;
 };
 
 template <typename T>
@@ -39,7 +40,7 @@ bool heap<T>::greater(const T& a, const T& b)
 template <typename T>
 heap<T>::heap(const unsigned max, bool (*cmp)(const T&, const T&))
 :
-cmp(cmp), size(0), max(max + 1), items(new T[max + 1])
+cmp(cmp), size(0), max(max), items(new T[max + 1])
 {
 }
 
@@ -106,4 +107,15 @@ bool heap<T>::pop(T& item)
     return true;
 }
 
+template <typename T>
+bool heap<T>::peek(T& item) const
+{
+    if(!size)
+        return false;
+
+    item = items[1];
+
+    return true;
+}
+
 #endif
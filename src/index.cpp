@@ -0,0 +1,364 @@
+/* C++ External-memory Index implementation by Vasileios Sioros */
+
+#include "index.h"
+#include "heap.h"
+#include <algorithm>
+#include <iomanip>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+const unsigned Index::fanIn = 64U;
+const unsigned long Index::minBudget = 1UL << 16;
+
+// Sorted Run Implementation:
+Index::Run::Run(const char * filename)
+:
+ifs(filename, std::ios::binary), document(0), frequency(0)
+{
+    term[0] = '\0';
+}
+
+// Each record is laid out as: length, term, document, frequency
+bool Index::Run::next()
+{
+    unsigned len;
+    if (!ifs.read((char *) &len, sizeof(len)) || len >= sizeof(term))
+        return false;
+
+    ifs.read(term, len); term[len] = '\0';
+    ifs.read((char *) &document, sizeof(document));
+    ifs.read((char *) &frequency, sizeof(frequency));
+
+    return ifs.good();
+}
+
+bool Index::before(Run * const & a, Run * const & b)
+{
+    const int cmp = std::strcmp(a->term, b->term);
+
+    return (cmp < 0 || (cmp == 0 && a->document < b->document));
+}
+
+// Index Files Implementation:
+Index::Files::Files(const char * prefix)
+:
+prefix(prefix), offset(0), start(0), words(0), finished(false)
+{
+    char filename[512];
+
+    std::snprintf(filename, sizeof(filename), "%s.lex", prefix);
+    lex.open(filename);
+    lex << std::setprecision(17);   // Enough for the IDF to survive the round trip
+
+    std::snprintf(filename, sizeof(filename), "%s.post", prefix);
+    post.open(filename, std::ios::binary);
+
+    std::snprintf(filename, sizeof(filename), "%s.docs", prefix);
+    docs.open(filename);
+}
+
+// Leave no partial index behind
+Index::Files::~Files()
+{
+    if (finished)
+        return;
+
+    lex.close(); post.close(); docs.close();
+
+    remove(prefix);
+}
+
+bool Index::Files::good() const
+{
+    return (lex.good() && post.good() && docs.good());
+}
+
+// Append to the current document, a space apart from its preceding words
+bool Index::Files::append(const char * text)
+{
+    if (words++)
+        docs << ' ';
+
+    return (docs << text).good();
+}
+
+// Mark the end of the current document
+bool Index::Files::close()
+{
+    words = 0;
+
+    return (docs << '\n').good();
+}
+
+bool Index::Files::posting(const unsigned document, const unsigned frequency)
+{
+    post.write((const char *) &document, sizeof(document));
+    post.write((const char *) &frequency, sizeof(frequency));
+
+    offset++;
+
+    return post.good();
+}
+
+// Write the lexicon entry of the term whose postings were written last
+bool Index::Files::term(const char * term, const unsigned documentFrequency, const double IDF)
+{
+    lex << term << ' ' << offset - start << ' ' << documentFrequency << ' ' << IDF << ' ' << start << '\n';
+
+    start = offset;
+
+    return lex.good();
+}
+
+bool Index::Files::finish()
+{
+    return (finished = (lex.flush() && post.flush() && docs.flush()));
+}
+
+void Index::Files::remove(const char * prefix)
+{
+    const char * extensions[] = { "docs", "lex", "post" };
+
+    char filename[512];
+    for (unsigned i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++)
+    {
+        std::snprintf(filename, sizeof(filename), "%s.%s", prefix, extensions[i]);
+        std::remove(filename);
+    }
+}
+
+// Index Implementation:
+// Half of the budget holds the buffered postings and the other half their terms
+Index::Index(const char * prefix, const unsigned long budget)
+:
+prefix(prefix),
+arenaSize((budget < minBudget ? minBudget : budget) / 2),
+entriesSize((budget < minBudget ? minBudget : budget) / 2 / sizeof(Entry)),
+arenaUsed(0), entriesUsed(0),
+arena(new char[arenaSize]), entries(new Entry[entriesSize]),
+first(0), runs(0), documents(0), files(prefix)
+{
+}
+
+// Remove any leftover runs, the output files being
+// removed by files in case the build did not finish
+Index::~Index()
+{
+    char filename[512];
+    for (unsigned id = first; id < runs; id++)
+    {
+        name(filename, id);
+        std::remove(filename);
+    }
+
+    delete[] entries;
+    delete[] arena;
+}
+
+bool Index::good() const
+{
+    return files.good();
+}
+
+void Index::name(char * filename, const unsigned id) const
+{
+    std::snprintf(filename, 512, "%s.run%u", prefix, id);
+}
+
+bool Index::add(const char * word, const unsigned documentId)
+{
+    const unsigned long len = std::strlen(word) + 1;
+
+    if (arenaUsed + len > arenaSize || entriesUsed == entriesSize)
+        if (!spill())
+            return false;
+
+    Entry& entry = entries[entriesUsed++];
+
+    entry.term = arenaUsed;
+    entry.document = documentId;
+    entry.frequency = 1;
+
+    std::memcpy(arena + arenaUsed, word, len);
+    arenaUsed += len;
+
+    return files.append(word);
+}
+
+// Mark the end of the current document
+bool Index::close()
+{
+    documents++;
+
+    return files.close();
+}
+
+// Sort the buffered postings by (term, document) and write them
+// to a new run, collapsing duplicates into a single frequency
+bool Index::spill()
+{
+    if (!entriesUsed)
+        return true;
+
+    struct Order
+    {
+        const char * arena;
+
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            const int cmp = std::strcmp(arena + a.term, arena + b.term);
+
+            return (cmp < 0 || (cmp == 0 && a.document < b.document));
+        }
+    } order = { arena };
+
+    std::sort(entries, entries + entriesUsed, order);
+
+    char filename[512]; name(filename, runs++);
+    std::ofstream ofs(filename, std::ios::binary);
+
+    for (unsigned long i = 0; i < entriesUsed && ofs.good(); )
+    {
+        const char * term = arena + entries[i].term;
+        const unsigned document = entries[i].document;
+
+        unsigned frequency = 0;
+        for (; i < entriesUsed && entries[i].document == document
+               && !std::strcmp(arena + entries[i].term, term); i++)
+            frequency += entries[i].frequency;
+
+        const unsigned len = (unsigned) std::strlen(term);
+
+        ofs.write((const char *) &len, sizeof(len));
+        ofs.write(term, len);
+        ofs.write((const char *) &document, sizeof(document));
+        ofs.write((const char *) &frequency, sizeof(frequency));
+    }
+
+    arenaUsed = entriesUsed = 0;
+
+    return ofs.good();
+}
+
+// Merge runs [from, to) either into a new run or, if final,
+// into the lexicon and postings files
+bool Index::merge(const unsigned from, const unsigned to, const bool final)
+{
+    char filename[512];
+
+    Run ** const run = new Run*[to - from];
+    heap<Run *> heads(to - from, before);
+
+    for (unsigned i = from; i < to; i++)
+    {
+        name(filename, i);
+        run[i - from] = new Run(filename);
+
+        if (run[i - from]->next())
+            heads.push(run[i - from]);
+    }
+
+    std::ofstream out;
+    if (!final)
+    {
+        name(filename, runs++);
+        out.open(filename, std::ios::binary);
+    }
+
+    char term[512] = { '\0' };
+    unsigned document = 0, frequency = 0, documentNum = 0;
+
+    // Write the pending (term, document, frequency) triple
+    auto emit = [&]()
+    {
+        if (final)
+        {
+            files.posting(document, frequency);
+
+            documentNum++;
+        }
+        else
+        {
+            const unsigned len = (unsigned) std::strlen(term);
+
+            out.write((const char *) &len, sizeof(len));
+            out.write(term, len);
+            out.write((const char *) &document, sizeof(document));
+            out.write((const char *) &frequency, sizeof(frequency));
+        }
+    };
+
+    // Write the lexicon entry of the current term
+    auto entry = [&]()
+    {
+        const double N = (double) documents, n = (double) documentNum;
+
+        files.term(term, documentNum, std::log10((N - n + 0.5) / (n + 0.5)));
+
+        documentNum = 0;
+    };
+
+    Run * head; bool pending = false;
+    while (heads.pop(head))
+    {
+        // A document's postings may be split amongst several runs
+        if (pending && head->document == document && !std::strcmp(head->term, term))
+        {
+            frequency += head->frequency;
+        }
+        else
+        {
+            if (pending)
+            {
+                emit();
+
+                if (final && std::strcmp(head->term, term))
+                    entry();
+            }
+
+            std::strcpy(term, head->term);
+            document = head->document; frequency = head->frequency;
+            pending = true;
+        }
+
+        if (head->next())
+            heads.push(head);
+    }
+
+    if (pending)
+    {
+        emit();
+
+        if (final)
+            entry();
+    }
+
+    for (unsigned i = from; i < to; i++)
+    {
+        delete run[i - from];
+
+        name(filename, i);
+        std::remove(filename);
+    }
+
+    delete[] run;
+
+    first = to;
+
+    return (final ? files.good() : out.good());
+}
+
+// Spill the remaining postings and merge the runs, fanIn at a time,
+// until a single pass produces the final index
+bool Index::finish()
+{
+    if (!spill())
+        return false;
+
+    while (runs - first > fanIn)
+        if (!merge(first, first + fanIn, false))
+            return false;
+
+    return (merge(first, runs, true) && files.finish());
+}
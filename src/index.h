@@ -0,0 +1,108 @@
+/* C++ External-memory Index implementation by Vasileios Sioros */
+
+#ifndef __INDEX__
+#define __INDEX__
+
+#include <fstream>
+
+// Builds the inverted index of corpora that do not fit in memory:
+// (term, document, frequency) triples are buffered within a fixed budget,
+// spilled as sorted runs to temporary files and finally k-way merged into
+//
+//   <prefix>.lex  : "term documentNum documentFrequency IDF offset" lines, lexicographically sorted
+//   <prefix>.post : (document, frequency) pairs of every term, starting at offset
+//   <prefix>.docs : the words of each document, single space separated, one document per line
+class Index
+{
+public:
+
+    // Index Files Implementation:
+    // Writes the files above, postings first and then the lexicon entry of their
+    // term, removing all of them unless finished; shared by build and pruneIndex
+    class Files
+    {
+        const char * const prefix;
+
+        std::ofstream lex, post, docs;
+
+        unsigned long offset, start;    // Postings written overall and before the current term
+        unsigned words;                 // Words of the current document
+        bool finished;
+
+    public:
+
+        Files(const char *);
+        ~Files();
+
+        bool good() const;
+
+        bool append(const char *);
+        bool close();
+
+        bool posting(const unsigned, const unsigned);
+        bool term(const char *, const unsigned, const double);
+
+        bool finish();
+
+        static void remove(const char *);
+    };
+
+private:
+
+    static const unsigned fanIn;    // Maximum number of runs merged at once
+    static const unsigned long minBudget;
+
+    // Buffered Posting Implementation:
+    struct Entry
+    {
+        unsigned long term;         // Offset of the term within the arena
+        unsigned document;
+        unsigned frequency;
+    };
+
+    // Sorted Run Implementation:
+    struct Run
+    {
+        std::ifstream ifs;
+
+        char term[512];
+        unsigned document, frequency;
+
+        Run(const char *);
+
+        bool next();
+    };
+
+    static bool before(Run * const &, Run * const &);
+
+    const char * const prefix;
+
+    const unsigned long arenaSize, entriesSize;
+    unsigned long arenaUsed, entriesUsed;
+
+    char  * const arena;            // Terms of the buffered postings
+    Entry * const entries;          // Buffered postings
+
+    unsigned first, runs;           // Runs [first, runs) are yet to be merged
+    unsigned documents;
+
+    Files files;
+
+    void name(char *, const unsigned) const;
+
+    bool spill();
+    bool merge(const unsigned, const unsigned, const bool);
+
+public:
+
+    Index(const char *, const unsigned long);
+    ~Index();
+
+    bool good() const;
+
+    bool add(const char *, const unsigned);
+    bool close();
+    bool finish();
+};
+
+#endif
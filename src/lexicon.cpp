@@ -0,0 +1,212 @@
+/* C++ Lexicon (Inverted Index) interface by Vasileios Sioros */
+
+#include "lexicon.h"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+// Posting List Implementation:
+PList::PList(const unsigned total)
+:
+capacity(1), IDF(0.0), documentNum(0), documentFrequency(0), instances(new unsigned[total]), documents(new unsigned[1]), maxFrequency(0)
+{
+    for (unsigned i = 0; i < total; i++)
+        instances[i] = 0;
+}
+
+PList::~PList()
+{
+    delete[] documents;
+    delete[] instances;
+}
+
+// Lexicon Implementation:
+Lexicon::Lexicon(const unsigned total)
+:
+total(total)
+{
+}
+
+Lexicon::~Lexicon()
+{
+}
+
+PList * Lexicon::create() const
+{
+    return new PList(total);
+}
+
+void Lexicon::destroy(PList * plist)
+{
+    delete plist;
+}
+
+// Update the Posting List & IDF given an occurrence in documentId
+// (documents are expected to be added in ascending order of their IDs)
+void Lexicon::update(PList * plist, const unsigned documentId) const
+{
+    if (!plist->instances[documentId]++)
+    {
+        if (plist->documentNum == plist->capacity)
+        {
+            unsigned * const documents = new unsigned[plist->capacity *= 2];
+            for (unsigned i = 0; i < plist->documentNum; i++)
+                documents[i] = plist->documents[i];
+
+            delete[] plist->documents;
+            plist->documents = documents;
+        }
+
+        plist->documents[plist->documentNum++] = documentId;
+        plist->documentFrequency = plist->documentNum;
+    }
+
+    if (plist->instances[documentId] > plist->maxFrequency)
+        plist->maxFrequency = plist->instances[documentId];
+
+    const double N = (double) total, n = (double) plist->documentNum;
+
+    plist->IDF = std::log10((N - n + 0.5) / (n + 0.5));
+}
+
+// Compute the next row of the edit distance matrix given the previous one
+// and return its minimum, which no continuation of the prefix can beat
+unsigned Lexicon::advance(const unsigned * previous, unsigned * row, const char * term, const unsigned len, const char letter)
+{
+    unsigned min = row[0] = previous[0] + 1;
+
+    for (unsigned i = 1; i <= len; i++)
+    {
+        const unsigned replace = previous[i - 1] + (term[i - 1] == letter ? 0 : 1);
+        const unsigned insert = previous[i] + 1, remove = row[i - 1] + 1;
+
+        row[i] = (replace < insert ? (replace < remove ? replace : remove) : (insert < remove ? insert : remove));
+
+        if (row[i] < min)
+            min = row[i];
+    }
+
+    return min;
+}
+
+// Keep the matches sorted by increasing distance (then decreasing document
+// frequency, then lexicographically) and, once max matches have been found,
+// only the best of them, so that an exact match is never displaced by more
+// frequent neighbours and the matches do not depend on the order terms are offered
+void Lexicon::offer(Match matches[], unsigned& size, const unsigned max, const char * term, const PList * plist, const unsigned distance)
+{
+    unsigned i = size;
+    for (; i > 0; i--)
+    {
+        const Match& other = matches[i - 1];
+        if (other.distance < distance ||
+           (other.distance == distance && other.plist->documentNum > plist->documentNum) ||
+           (other.distance == distance && other.plist->documentNum == plist->documentNum && std::strcmp(other.term, term) <= 0))
+            break;
+
+        if (i < max)
+            matches[i] = other;
+    }
+
+    if (i < max)
+    {
+        std::strcpy(matches[i].term, term);
+        matches[i].plist = plist;
+        matches[i].distance = distance;
+    }
+
+    if (size < max)
+        size++;
+}
+
+// Without any prefix structure to prune with, run the automaton on
+// every term of the vocabulary, abandoning each as soon as it fails
+unsigned Lexicon::fuzzy(const char * term, const unsigned distance, Match matches[], const unsigned max) const
+{
+    struct Scan
+    {
+        const char * term;
+        unsigned len, distance;
+        unsigned * rows;
+
+        Match * matches;
+        unsigned size, max;
+
+        static void visit(const char * word, const PList * plist, void * arg)
+        {
+            Scan& scan = *(Scan *) arg;
+
+            const unsigned wlen = (unsigned) std::strlen(word);
+            if (wlen > scan.len + scan.distance || wlen + scan.distance < scan.len)
+                return;
+
+            unsigned * previous = scan.rows, * row = scan.rows + scan.len + 1;
+            for (unsigned i = 0; i <= scan.len; i++)
+                previous[i] = i;
+
+            for (unsigned j = 0; j < wlen; j++)
+            {
+                if (advance(previous, row, scan.term, scan.len, word[j]) > scan.distance)
+                    return;
+
+                unsigned * tmp = previous; previous = row; row = tmp;
+            }
+
+            if (previous[scan.len] <= scan.distance)
+                offer(scan.matches, scan.size, scan.max, word, plist, previous[scan.len]);
+        }
+    } scan;
+
+    scan.term = term; scan.len = (unsigned) std::strlen(term); scan.distance = distance;
+    scan.rows = new unsigned[2 * (scan.len + 1)];
+    scan.matches = matches; scan.size = 0; scan.max = max;
+
+    visit(Scan::visit, &scan);
+
+    delete[] scan.rows;
+
+    return scan.size;
+}
+
+// Visit the terms starting with the given prefix, in lexicographic order
+void Lexicon::prefix(const char * string, Visitor visitor, void * arg) const
+{
+    struct Filter
+    {
+        const char * prefix;
+        unsigned len;
+
+        Visitor visitor;
+        void * arg;
+
+        static void visit(const char * term, const PList * plist, void * arg)
+        {
+            const Filter& filter = *(const Filter *) arg;
+
+            if (!std::strncmp(term, filter.prefix, filter.len))
+                filter.visitor(term, plist, filter.arg);
+        }
+    } filter = { string, (unsigned) std::strlen(string), visitor, arg };
+
+    visit(Filter::visit, &filter);
+}
+
+Lexicon * Lexicon::freeze()
+{
+    return this;
+}
+
+static void printer(const char * term, const PList * plist, void *)
+{
+    std::cout << term << ' ' << plist->documentNum << std::endl;
+}
+
+void Lexicon::print() const
+{
+    visit(printer, nullptr);
+}
+
+void Lexicon::print(const char * string) const
+{
+    prefix(string, printer, nullptr);
+}
@@ -0,0 +1,81 @@
+/* C++ Lexicon (Inverted Index) interface by Vasileios Sioros */
+
+#ifndef __LEXICON__
+#define __LEXICON__
+
+// Posting List Implementation:
+class PList
+{
+    friend class Lexicon;
+
+    PList(const unsigned);
+    ~PList();
+
+    unsigned capacity;          // Allocation size of documents
+
+public:
+
+    double IDF;                 // Inverse Document Frequency
+    unsigned documentNum;       // Counter of non-zero entries
+    unsigned documentFrequency; // Documents containing the term, static pruning notwithstanding
+    unsigned * const instances; // Pairs of: (1) Document IDs        (i)
+                                // and       (2) Word Usage Counters (instances[i])
+    unsigned * documents;       // IDs of the non-zero entries in ascending order
+    unsigned maxFrequency;      // Maximum of the Word Usage Counters
+};
+
+// Every lexicon backend (trie, hash table etc) maps each term to its
+// Posting List and owns the Posting Lists it has created
+class Lexicon
+{
+public:
+
+    // Visitor of every (term, Posting List) pair
+    typedef void (*Visitor)(const char *, const PList *, void *);
+
+    // Fuzzy Match Implementation:
+    struct Match
+    {
+        char term[512];
+        const PList * plist;
+        unsigned distance;      // Edit (Levenshtein) distance from the searched term
+    };
+
+protected:
+
+    const unsigned total;       // Allocation size of this lexicon's PList::instances
+
+    PList * create() const;
+    void update(PList *, const unsigned) const;
+    static void destroy(PList *);
+
+    // Levenshtein automaton: the state after consuming letter is the row of
+    // edit distances between the consumed prefix and every prefix of term
+    static unsigned advance(const unsigned *, unsigned *, const char *, const unsigned, const char);
+    static void offer(Match [], unsigned&, const unsigned, const char *, const PList *, const unsigned);
+
+public:
+
+    Lexicon(const unsigned);
+    virtual ~Lexicon();
+
+    virtual void add(const char *, const unsigned) = 0;
+    virtual const PList * lookup(const char *) const = 0;
+    virtual void visit(Visitor, void *) const = 0;
+    virtual void prefix(const char *, Visitor, void *) const;
+
+    // Find (at most max) terms within the given edit distance, closest (then most frequent) first
+    virtual unsigned fuzzy(const char *, const unsigned, Match [], const unsigned) const;
+
+    // Make the lexicon read-only, possibly switching to a more compact representation;
+    // if another lexicon is returned, it has taken over the Posting Lists of this one
+    virtual Lexicon * freeze();
+
+    // Memory occupied by the lexicon's structure, excluding the Posting Lists
+    virtual unsigned long bytes() const = 0;
+
+    virtual void print() const;
+    void print(const char *) const;
+};
+
+#endif
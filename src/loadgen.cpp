@@ -0,0 +1,322 @@
+/* C++ Search Engine Load Generator by Vasileios Sioros */
+
+#include "engine.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+static const unsigned maxQuery = 512U, maxWords = 4U;
+
+// Query Source Implementation:
+// Either the lines of a query log, replayed in order (and from the top once
+// exhausted), or queries of 1 to 4 terms drawn from a Zipfian distribution
+// over the vocabulary of the index, ranked by decreasing document frequency
+struct Queries
+{
+    unsigned size;
+    char (* queries)[maxQuery];
+
+    Queries(const char *, const unsigned);
+    Queries(const Engine&, const double, const unsigned);
+    ~Queries();
+};
+
+Queries::Queries(const char * filename, const unsigned count)
+:
+size(0), queries(new char[count][maxQuery])
+{
+    std::ifstream ifs(filename);
+
+    unsigned lines = 0;
+    for (std::string line; std::getline(ifs, line); )
+        if (line.find_first_not_of(" \t\r") != std::string::npos)
+            lines++;
+
+    for (; size < count && lines; )
+    {
+        ifs.clear(); ifs.seekg(std::ios::beg);
+
+        for (std::string line; size < count && std::getline(ifs, line); )
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+            {
+                std::strncpy(queries[size], line.c_str(), maxQuery - 1);
+                queries[size++][maxQuery - 1] = '\0';
+            }
+    }
+}
+
+Queries::Queries(const Engine& eng, const double exponent, const unsigned count)
+:
+size(0), queries(new char[count][maxQuery])
+{
+    // Vocabulary Implementation:
+    struct Vocabulary
+    {
+        struct Term
+        {
+            char * word;
+            unsigned documentNum;
+        } * terms;
+
+        unsigned size, capacity;
+
+        static void visit(const char * word, const PList * plist, void * arg)
+        {
+            Vocabulary& vocabulary = *(Vocabulary *) arg;
+
+            if (vocabulary.size == vocabulary.capacity)
+            {
+                Term * const terms = new Term[vocabulary.capacity *= 2];
+                for (unsigned i = 0; i < vocabulary.size; i++)
+                    terms[i] = vocabulary.terms[i];
+
+                delete[] vocabulary.terms;
+                vocabulary.terms = terms;
+            }
+
+            Term& term = vocabulary.terms[vocabulary.size++];
+
+            term.word = new char[std::strlen(word) + 1];
+            std::strcpy(term.word, word);
+            term.documentNum = plist->documentNum;
+        }
+    } vocabulary = { new Vocabulary::Term[1024], 0, 1024 };
+
+    eng.vocabulary(Vocabulary::visit, &vocabulary);
+
+    struct ByFrequency
+    {
+        bool operator()(const Vocabulary::Term& a, const Vocabulary::Term& b) const { return a.documentNum > b.documentNum; }
+    } byFrequency;
+
+    std::stable_sort(vocabulary.terms, vocabulary.terms + vocabulary.size, byFrequency);
+
+    // The cumulative distribution of the rank r being drawn, proportional to 1 / r^exponent
+    double * const cdf = new double[vocabulary.size + 1];
+
+    double sum = 0.0;
+    for (unsigned r = 0; r < vocabulary.size; r++)
+        cdf[r] = (sum += 1.0 / std::pow((double) (r + 1), exponent));
+
+    std::mt19937 generator(1U);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+
+    for (; size < count && vocabulary.size; size++)
+    {
+        const unsigned words = 1U + (unsigned) generator() % maxWords;
+
+        queries[size][0] = '\0';
+        for (unsigned i = 0; i < words; i++)
+        {
+            const unsigned r = (unsigned) (std::upper_bound(cdf, cdf + vocabulary.size, uniform(generator)) - cdf);
+            const char * const word = vocabulary.terms[r < vocabulary.size ? r : vocabulary.size - 1].word;
+
+            if (std::strlen(queries[size]) + std::strlen(word) + 2 >= maxQuery)
+                break;
+
+            std::strcat(queries[size], " ");
+            std::strcat(queries[size], word);
+        }
+    }
+
+    delete[] cdf;
+
+    for (unsigned i = 0; i < vocabulary.size; i++)
+        delete[] vocabulary.terms[i].word;
+
+    delete[] vocabulary.terms;
+}
+
+Queries::~Queries()
+{
+    delete[] queries;
+}
+
+// Load Implementation:
+// Closed loop: each worker issues its next query only once the previous one
+// has been answered; given a target rate, the i-th query is not issued before
+// i / QPS seconds have elapsed, so that the workers never exceed it. Its response
+// time is then measured from that scheduled time rather than from when it was
+// actually issued, so that the time it spent waiting for a worker once the engine
+// falls behind is accounted for (avoiding coordinated omission)
+struct Load
+{
+    const Engine * eng;
+    const Queries * queries;
+    unsigned maxResults;
+    double qps;
+
+    std::atomic<unsigned> next;
+    std::atomic<unsigned> errors;
+    double * responses;         // Microseconds from each query's scheduled time to its answer
+    double * services;          // Microseconds from issuing each query to its answer
+
+    Clock::time_point start;
+
+    static void worker(Load *);
+};
+
+void Load::worker(Load * load)
+{
+    Engine::Result * const results = new Engine::Result[load->maxResults];
+    char buffer[maxQuery];
+
+    for (unsigned i; (i = load->next++) < load->queries->size; )
+    {
+        Clock::time_point scheduled;
+        if (load->qps > 0.0)
+            std::this_thread::sleep_until(scheduled = load->start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((double) i / load->qps)));
+
+        // Searching consumes its input
+        std::strcpy(buffer, load->queries->queries[i]);
+
+        const Clock::time_point issued = Clock::now();
+
+        // A query that yields nothing has been rejected as invalid
+        if (!load->eng->query(buffer, results))
+            load->errors++;
+
+        const Clock::time_point answered = Clock::now();
+
+        load->services[i] = std::chrono::duration<double, std::micro>(answered - issued).count();
+        load->responses[i] = (load->qps > 0.0 ? std::chrono::duration<double, std::micro>(answered - scheduled).count() : load->services[i]);
+    }
+
+    delete[] results;
+}
+
+// Nearest rank percentile of the sorted latencies
+static double percentile(const double sorted[], const unsigned size, const double p)
+{
+    const unsigned rank = (unsigned) std::ceil(p * (double) size);
+
+    return sorted[rank ? rank - 1 : 0];
+}
+
+int main(int argc, char * argv[])
+{
+    enum { FILE_FLAG = 1, FILE_INPUT };
+    const char error[] = "<Error>: Usage: ./loadgen -i docfile [-q querylog | -z exponent] [-c concurrency] [-t target QPS] [-n queries] [-k maxResults]";
+
+    if (argc < 3 || std::strcmp(argv[FILE_FLAG], "-i"))
+    {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+
+    // Optional flags: -q query log (by default a Zipfian sample of the vocabulary)
+    //                 -z exponent of the Zipfian distribution (default 1.0)
+    //                 -c concurrent workers (default 1)
+    //                 -t target queries per second (default 0, that is unthrottled)
+    //                 -n queries to issue (default 10000)
+    //                 -k maxResults (default 10)
+    const char * log = nullptr;
+    double exponent = 1.0, qps = 0.0;
+    int concurrency = 1, count = 10000, maxResults = 10;
+    for (int i = FILE_INPUT + 1; i < argc; i += 2)
+    {
+        if (i + 1 < argc && !std::strcmp(argv[i], "-q"))
+        {
+            log = argv[i + 1];
+            continue;
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-z") && (exponent = std::atof(argv[i + 1])) > 0.0)
+            continue;
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-c") && (concurrency = std::atoi(argv[i + 1])) > 0)
+            continue;
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-t") && (qps = std::atof(argv[i + 1])) >= 0.0)
+            continue;
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-n") && (count = std::atoi(argv[i + 1])) > 0)
+            continue;
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-k") && (maxResults = std::atoi(argv[i + 1])) > 0)
+            continue;
+
+        std::cerr << error << std::endl;
+        return -2;
+    }
+
+    const Engine * const eng = Engine::validate(argv[FILE_INPUT], (unsigned) maxResults);
+    if (!eng)
+        return -3;
+
+    const Queries * const queries = (log ? new Queries(log, (unsigned) count) : new Queries(*eng, exponent, (unsigned) count));
+    if (!queries->size)
+    {
+        std::cerr << "<Error>: No queries to issue" << std::endl;
+
+        delete queries;
+        delete eng;
+
+        return -4;
+    }
+
+    Load load;
+    load.eng = eng; load.queries = queries; load.maxResults = (unsigned) maxResults; load.qps = qps;
+    load.next = 0; load.errors = 0;
+    load.responses = new double[queries->size];
+    load.services = new double[queries->size];
+
+    std::thread ** const workers = new std::thread*[concurrency];
+
+    load.start = Clock::now();
+
+    for (int w = 0; w < concurrency; w++)
+        workers[w] = new std::thread(Load::worker, &load);
+
+    for (int w = 0; w < concurrency; w++)
+    {
+        workers[w]->join();
+        delete workers[w];
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - load.start).count();
+
+    std::sort(load.responses, load.responses + queries->size);
+    std::sort(load.services, load.services + queries->size);
+
+    std::cout << "\n[Load: " << queries->size << " queries (" << (log ? log : "zipfian vocabulary sample") << "), "
+              << concurrency << " workers, target ";
+    if (qps > 0.0)
+        std::cout << qps << " QPS]" << std::endl;
+    else
+        std::cout << "unthrottled]" << std::endl;
+
+    std::cout << std::setw(10) << "queries" << std::setw(10) << "errors" << std::setw(12) << "seconds" << std::setw(12) << "QPS" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(10) << queries->size << std::setw(10) << load.errors.load() << std::setw(12) << seconds
+              << std::setw(12) << (double) queries->size / seconds << std::endl;
+
+    // Given a target rate: the response time, from the scheduled time, and the
+    // service time, from the actual issue, which excludes any queueing delay
+    const char * names[] = { "response", "service" };
+    const double * latencies[] = { load.responses, load.services };
+
+    std::cout << '\n' << std::setw(10) << "latency" << std::setw(12) << "p50 (us)" << std::setw(12) << "p99 (us)"
+              << std::setw(12) << "p999 (us)" << std::setw(12) << "max (us)" << std::endl;
+
+    for (unsigned l = (qps > 0.0 ? 0 : 1); l < 2; l++)
+        std::cout << std::setw(10) << names[l]
+                  << std::setw(12) << percentile(latencies[l], queries->size, 0.50)
+                  << std::setw(12) << percentile(latencies[l], queries->size, 0.99)
+                  << std::setw(12) << percentile(latencies[l], queries->size, 0.999)
+                  << std::setw(12) << latencies[l][queries->size - 1] << std::endl;
+
+    delete[] workers;
+    delete[] load.services;
+    delete[] load.responses;
+    delete queries;
+    delete eng;
+
+    return 0;
+}
@@ -0,0 +1,290 @@
+/* C++ LOUDS Trie (Inverted Index) implementation by Vasileios Sioros */
+
+#include "louds.h"
+#include <cstring>
+
+// Rank/Select Bit Vector Implementation:
+const unsigned Louds::Bits::block = 512U;
+
+Louds::Bits::Bits(const unsigned size)
+:
+size(size), words(new unsigned long[size / 64 + 1]), ranks(new unsigned[size / block + 2])
+{
+    for (unsigned i = 0; i <= size / 64; i++)
+        words[i] = 0UL;
+}
+
+Louds::Bits::~Bits()
+{
+    delete[] ranks;
+    delete[] words;
+}
+
+void Louds::Bits::set(const unsigned position)
+{
+    words[position / 64] |= 1UL << (position % 64);
+}
+
+bool Louds::Bits::get(const unsigned position) const
+{
+    return (words[position / 64] >> (position % 64)) & 1UL;
+}
+
+void Louds::Bits::build()
+{
+    const unsigned perBlock = block / 64;
+
+    ranks[0] = 0;
+    for (unsigned b = 0; b <= size / block; b++)
+    {
+        ranks[b + 1] = ranks[b];
+        for (unsigned w = b * perBlock; w < (b + 1) * perBlock && w <= size / 64; w++)
+            ranks[b + 1] += (unsigned) __builtin_popcountl(words[w]);
+    }
+}
+
+unsigned Louds::Bits::rank1(const unsigned position) const
+{
+    unsigned rank = ranks[position / block];
+
+    for (unsigned w = (position / block) * (block / 64); w < position / 64; w++)
+        rank += (unsigned) __builtin_popcountl(words[w]);
+
+    if (position % 64)
+        rank += (unsigned) __builtin_popcountl(words[position / 64] & ((1UL << (position % 64)) - 1UL));
+
+    return rank;
+}
+
+// Binary search the last block preceded by less than i zeros,
+// then scan its words and finally the bits of the word containing it
+unsigned Louds::Bits::select0(unsigned i) const
+{
+    unsigned lo = 0, hi = size / block;
+    while (lo < hi)
+    {
+        const unsigned mid = (lo + hi + 1) / 2;
+
+        if (mid * block - ranks[mid] < i)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    i -= lo * block - ranks[lo];
+
+    unsigned w = lo * (block / 64);
+    for (unsigned zeros; (zeros = 64U - (unsigned) __builtin_popcountl(words[w])) < i; w++)
+        i -= zeros;
+
+    unsigned long word = ~words[w];
+    for (; i > 1; i--)
+        word &= word - 1UL;
+
+    return w * 64 + (unsigned) __builtin_ctzl(word);
+}
+
+unsigned long Louds::Bits::bytes() const
+{
+    return (size / 64 + 1) * sizeof(unsigned long) + (size / block + 2) * sizeof(unsigned);
+}
+
+// LOUDS Implementation:
+unsigned Louds::count(PList * const lists[], const unsigned nodes)
+{
+    unsigned terms = 0;
+    for (unsigned v = 0; v < nodes; v++)
+        if (lists[v])
+            terms++;
+
+    return terms;
+}
+
+Louds::Louds(const unsigned total, const unsigned nodes, const unsigned degrees[], const char letters[], PList * const lists[])
+:
+Lexicon(total), nodes(nodes), terms(count(lists, nodes)), tree(2 * nodes + 1), terminal(nodes),
+labels(new char[nodes]), plists(new PList*[terms ? terms : 1])
+{
+    unsigned position = 0, term = 0;
+
+    tree.set(position); position += 2;
+    for (unsigned v = 0; v < nodes; v++)
+    {
+        for (unsigned d = 0; d < degrees[v]; d++)
+            tree.set(position++);
+
+        position++;
+
+        labels[v] = letters[v];
+
+        if (lists[v])
+        {
+            terminal.set(v);
+            plists[term++] = lists[v];
+        }
+    }
+
+    tree.build();
+    terminal.build();
+}
+
+Louds::~Louds()
+{
+    for (unsigned i = 0; i < terms; i++)
+        destroy(plists[i]);
+
+    delete[] plists;
+    delete[] labels;
+}
+
+// The children of node v are numbered first, first + 1, ..., first + degree - 1;
+// the degree of node v lies between the (v + 1)-th and the (v + 2)-th zero
+void Louds::children(const unsigned v, unsigned& first, unsigned& degree) const
+{
+    const unsigned start = tree.select0(v + 1) + 1;
+
+    first = tree.rank1(start);
+    degree = tree.select0(v + 2) - start;
+}
+
+const PList * Louds::plist(const unsigned v) const
+{
+    return (terminal.get(v) ? plists[terminal.rank1(v)] : nullptr);
+}
+
+// A frozen lexicon is read-only
+void Louds::add(const char *, const unsigned)
+{
+}
+
+// Binary search each node's (sorted) children for the next letter
+const PList * Louds::lookup(const char * string) const
+{
+    unsigned v = 0;
+
+    for (; *string; string++)
+    {
+        unsigned first, degree;
+        children(v, first, degree);
+
+        unsigned lo = first, hi = first + degree;
+        while (lo < hi)
+        {
+            const unsigned mid = (lo + hi) / 2;
+
+            if (labels[mid] < *string)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if (lo == first + degree || labels[lo] != *string)
+            return nullptr;
+
+        v = lo;
+    }
+
+    return (v ? plist(v) : nullptr);
+}
+
+void Louds::visit(const unsigned v, Visitor visitor, void * arg, char * word, const unsigned depth) const
+{
+    unsigned first, degree;
+    children(v, first, degree);
+
+    for (unsigned c = first; c < first + degree; c++)
+    {
+        word[depth] = labels[c]; word[depth + 1] = '\0';
+
+        const PList * const pl = plist(c);
+        if (pl)
+            visitor(word, pl, arg);
+
+        visit(c, visitor, arg, word, depth + 1);
+    }
+}
+
+void Louds::visit(Visitor visitor, void * arg) const
+{
+    char word[512];
+
+    visit(0, visitor, arg, word, 0);
+}
+
+// Descend to the node of the prefix and visit its subtree
+void Louds::prefix(const char * string, Visitor visitor, void * arg) const
+{
+    const unsigned len = (unsigned) std::strlen(string);
+    if (len >= 512)
+        return;
+
+    unsigned v = 0;
+    for (unsigned i = 0; i < len; i++)
+    {
+        unsigned first, degree, c;
+        children(v, first, degree);
+
+        for (c = first; c < first + degree && labels[c] != string[i]; c++);
+
+        if (c == first + degree)
+            return;
+
+        v = c;
+    }
+
+    char word[512];
+    std::strcpy(word, string);
+
+    const PList * const pl = (v ? plist(v) : nullptr);
+    if (pl)
+        visitor(word, pl, arg);
+
+    visit(v, visitor, arg, word, len);
+}
+
+// Same as Trie::fuzzy, walking the children by rank/select instead of pointers
+void Louds::fuzzy(const unsigned v, Fuzzy& search, const unsigned depth) const
+{
+    const unsigned * const previous = search.rows + depth * (search.len + 1);
+    unsigned * const row = search.rows + (depth + 1) * (search.len + 1);
+
+    unsigned first, degree;
+    children(v, first, degree);
+
+    for (unsigned c = first; c < first + degree; c++)
+    {
+        if (advance(previous, row, search.term, search.len, labels[c]) > search.distance)
+            continue;
+
+        search.word[depth] = labels[c]; search.word[depth + 1] = '\0';
+
+        const PList * const pl = plist(c);
+        if (pl && row[search.len] <= search.distance)
+            offer(search.matches, search.size, search.max, search.word, pl, row[search.len]);
+
+        fuzzy(c, search, depth + 1);
+    }
+}
+
+unsigned Louds::fuzzy(const char * term, const unsigned distance, Match matches[], const unsigned max) const
+{
+    Fuzzy search;
+
+    search.term = term; search.len = (unsigned) std::strlen(term); search.distance = distance;
+    search.matches = matches; search.size = 0; search.max = max;
+
+    search.rows = new unsigned[(search.len + distance + 2) * (search.len + 1)];
+    for (unsigned i = 0; i <= search.len; i++)
+        search.rows[i] = i;
+
+    fuzzy(0, search, 0);
+
+    delete[] search.rows;
+
+    return search.size;
+}
+
+unsigned long Louds::bytes() const
+{
+    return sizeof(*this) + tree.bytes() + terminal.bytes() + nodes * sizeof(char) + terms * sizeof(PList *);
+}
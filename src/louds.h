@@ -0,0 +1,79 @@
+/* C++ LOUDS Trie (Inverted Index) implementation by Vasileios Sioros */
+
+#ifndef __LOUDS__
+#define __LOUDS__
+
+#include "lexicon.h"
+
+// Succinct, read-only trie (Level-Order Unary Degree Sequence):
+// the nodes are numbered in breadth first order and each node is encoded
+// by its degree in unary (1...10), so that the whole tree takes 2n + 1 bits
+// plus a letter per node, and is navigated by rank/select on the bits
+class Louds : public Lexicon
+{
+    // Rank/Select Bit Vector Implementation:
+    struct Bits
+    {
+        static const unsigned block;    // Bits per rank sample
+
+        const unsigned size;
+        unsigned long * const words;
+        unsigned * const ranks;         // Ones preceding each block
+
+        Bits(const unsigned);
+        ~Bits();
+
+        void set(const unsigned);
+        bool get(const unsigned) const;
+        void build();
+
+        unsigned rank1(const unsigned) const;   // Ones in [0, position)
+        unsigned select0(const unsigned) const; // Position of the i-th (1-based) zero
+
+        unsigned long bytes() const;
+    };
+
+    const unsigned nodes, terms;
+
+    Bits tree;                  // "10" (super root) followed by each node's degree in unary
+    Bits terminal;              // Whether each node completes a term
+    char * const labels;        // The letter of each node
+    PList ** const plists;      // The Posting List of each terminal node
+
+    static unsigned count(PList * const [], const unsigned);
+
+    void children(const unsigned, unsigned&, unsigned&) const;
+    const PList * plist(const unsigned) const;
+
+    // Fuzzy Search Implementation:
+    struct Fuzzy
+    {
+        const char * term;
+        unsigned len, distance;
+
+        unsigned * rows;        // A row of the automaton per depth
+        char word[512];
+
+        Match * matches;
+        unsigned size, max;
+    };
+
+    void visit(const unsigned, Visitor, void *, char *, const unsigned) const;
+    void fuzzy(const unsigned, Fuzzy&, const unsigned) const;
+
+public:
+
+    // Given the nodes in breadth first order: their degrees, letters and Posting Lists
+    Louds(const unsigned, const unsigned, const unsigned [], const char [], PList * const []);
+    ~Louds();
+
+    void add(const char *, const unsigned);
+    const PList * lookup(const char *) const;
+    void visit(Visitor, void *) const;
+    void prefix(const char *, Visitor, void *) const;
+    unsigned fuzzy(const char *, const unsigned, Match [], const unsigned) const;
+
+    unsigned long bytes() const;
+};
+
+#endif
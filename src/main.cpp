@@ -1,12 +1,25 @@
 
 #include "engine.h"
+#include "trace.h"
+#include "renderer.h"
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
+#include <cctype>
+
+// Whether the input is the given command, i.e. begins with
+// it followed by either whitespace or nothing at all
+static bool command(const char * input, const char * name)
+{
+    const unsigned long len = std::strlen(name);
+
+    return (!std::strncmp(input, name, len) && (!input[len] || std::isspace(input[len])));
+}
 
 int main(int argc, char * argv[])
 {
-    enum { FILE_FLAG = 1, FILE_INPUT, MAXQ_FLAG, MAXQ_INPUT };
+    enum { FILE_FLAG = 1, FILE_INPUT, MAXQ_FLAG, MAXQ_INPUT, BDGT_FLAG, BDGT_INPUT };
     const char error[] = "<Error>: Unable to recognize arguement format";
     
     if (argc < 5)
@@ -15,6 +28,62 @@ int main(int argc, char * argv[])
         return -1;
     }
     
+    // External-memory build mode: -i docfile -b prefix [-m budget (MB)]
+    if (!std::strcmp(argv[FILE_FLAG], "-i") && !std::strcmp(argv[MAXQ_FLAG], "-b"))
+    {
+        int budget = 64;
+        if (argc > BDGT_INPUT && (std::strcmp(argv[BDGT_FLAG], "-m") || (budget = std::atoi(argv[BDGT_INPUT])) <= 0))
+        {
+            std::cerr << error << std::endl;
+            return -2;
+        }
+
+        return (Engine::build(argv[FILE_INPUT], argv[MAXQ_INPUT], (unsigned long) budget << 20) ? 0 : -3);
+    }
+
+    // Static pruning mode: -i docfile -s prefix [-k maxResults (default 10)] [-m term | document]
+    //                     [-e epsilon (default 0.5)] [-x maxDF (fraction of the documents)]
+    //                     [-r ranking]
+    if (!std::strcmp(argv[FILE_FLAG], "-i") && !std::strcmp(argv[MAXQ_FLAG], "-s"))
+    {
+        Engine::Pruning pruning = Engine::TERM_CENTRIC;
+        Engine::Ranking ranking = Engine::BM25;
+        double epsilon = 0.5, maxDF = 2.0;
+        int maxResults = 10;
+        for (int i = MAXQ_INPUT + 1; i < argc; i += 2)
+        {
+            if (i + 1 < argc && !std::strcmp(argv[i], "-k") && (maxResults = std::atoi(argv[i + 1])) > 0)
+                continue;
+            else if (i + 1 < argc && !std::strcmp(argv[i], "-e") && (epsilon = std::atof(argv[i + 1])) > 0.0)
+                continue;
+            else if (i + 1 < argc && !std::strcmp(argv[i], "-x") && (maxDF = std::atof(argv[i + 1])) > 0.0)
+                continue;
+            else if (i + 1 < argc && !std::strcmp(argv[i], "-m") && (!std::strcmp(argv[i + 1], "term") || !std::strcmp(argv[i + 1], "document")))
+            {
+                pruning = (argv[i + 1][0] == 't' ? Engine::TERM_CENTRIC : Engine::DOCUMENT_CENTRIC);
+                continue;
+            }
+            else if (i + 1 < argc && !std::strcmp(argv[i], "-r"))
+            {
+                const char * names[] = { "generic", "bm25", "bm25+", "bm25l", "tfidf" };
+
+                unsigned j = 0;
+                for (; j < sizeof(names) / sizeof(names[0]) && std::strcmp(argv[i + 1], names[j]); j++);
+
+                if (j < sizeof(names) / sizeof(names[0]))
+                {
+                    ranking = (Engine::Ranking) j;
+                    continue;
+                }
+            }
+
+            std::cerr << error << std::endl;
+            return -2;
+        }
+
+        return (Engine::pruneIndex(argv[FILE_INPUT], argv[MAXQ_INPUT], (unsigned) maxResults, pruning, epsilon, maxDF, ranking) ? 0 : -3);
+    }
+
     const int maxResults = std::atoi(argv[MAXQ_INPUT]);
     if (std::strcmp(argv[FILE_FLAG], "-i") || std::strcmp(argv[MAXQ_FLAG], "-k") || maxResults <= 0)
     {
@@ -22,14 +91,90 @@ int main(int argc, char * argv[])
         return -2;
     }
 
+    // Optional flags: -r ranking (bm25, bm25+, bm25l, tfidf or generic)
+    //                 -l lexicon (trie, hash, mph or louds)
+    //                 -t threshold (ms) above which a query's trace is dumped
+    //                 -p threads scanning the partitions of a query (default 1)
+    //                 -o output (pretty or compact, i.e. a tab separated line per result)
+    //                 -f input format (docs, the default, or index, i.e. the prefix given to -b or -s)
+    Engine::Ranking ranking = Engine::BM25;
+    Engine::Backend backend = Engine::TRIE;
+    Renderer::Mode output = Renderer::PRETTY;
+    int threshold = -1, threads = 1;
+    bool index = false;
+    for (int i = MAXQ_INPUT + 1; i < argc; i += 2)
+    {
+        if (i + 1 < argc && !std::strcmp(argv[i], "-r"))
+        {
+            const char * names[] = { "generic", "bm25", "bm25+", "bm25l", "tfidf" };
+
+            unsigned j = 0;
+            for (; j < sizeof(names) / sizeof(names[0]) && std::strcmp(argv[i + 1], names[j]); j++);
+
+            if (j < sizeof(names) / sizeof(names[0]))
+            {
+                ranking = (Engine::Ranking) j;
+                continue;
+            }
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-l"))
+        {
+            const char * names[] = { "trie", "hash", "mph", "louds" };
+
+            unsigned j = 0;
+            for (; j < sizeof(names) / sizeof(names[0]) && std::strcmp(argv[i + 1], names[j]); j++);
+
+            if (j < sizeof(names) / sizeof(names[0]))
+            {
+                backend = (Engine::Backend) j;
+                continue;
+            }
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-t") && (threshold = std::atoi(argv[i + 1])) >= 0)
+        {
+            continue;
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-p") && (threads = std::atoi(argv[i + 1])) > 0)
+        {
+            continue;
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-o"))
+        {
+            const char * names[] = { "pretty", "compact" };
+
+            unsigned j = 0;
+            for (; j < sizeof(names) / sizeof(names[0]) && std::strcmp(argv[i + 1], names[j]); j++);
+
+            if (j < sizeof(names) / sizeof(names[0]))
+            {
+                output = (Renderer::Mode) j;
+                continue;
+            }
+        }
+        else if (i + 1 < argc && !std::strcmp(argv[i], "-f") && (!std::strcmp(argv[i + 1], "docs") || !std::strcmp(argv[i + 1], "index")))
+        {
+            index = (argv[i + 1][0] == 'i');
+            continue;
+        }
+
+        std::cerr << error << std::endl;
+        return -2;
+    }
+
+    Trace::enable(true);
+
     const Engine * eng;
-    if (!(eng = Engine::validate(argv[FILE_INPUT], (unsigned) maxResults)))
+    if (!(eng = (index ? Engine::open(argv[FILE_INPUT], (unsigned) maxResults, ranking, backend, (unsigned) threads)
+                       : Engine::validate(argv[FILE_INPUT], (unsigned) maxResults, ranking, backend, (unsigned) threads))))
         return -3;
 
     // Comment out this line if it bothers your diff
     std::cout << "\n~ Welcome to Googolplex ~" << std::endl;
 
+    Renderer renderer(output);
+
     char cmd[512]; const char del[] = " \t";
+    unsigned slow = 0;
     do
     {
         // Comment out this line if it bothers your diff
@@ -37,21 +182,54 @@ int main(int argc, char * argv[])
         
         std::cin.getline(cmd, 512);
 
-        if (!std::strncmp(cmd, "/search", 7))
+        const long started = Trace::now();
+
+        if (command(cmd, "/search"))
+        {
+            eng->search(cmd + 7, renderer);
+        }
+        else if (command(cmd, "/similar"))
         {
-            eng->search(cmd + 7);
+            const char * tok[] = { std::strtok(cmd + 8, del), std::strtok(nullptr, del) };
+
+            if (tok[0])
+                eng->similar(std::atoi(tok[0]), (tok[1] && std::atoi(tok[1]) > 0 ? (unsigned) std::atoi(tok[1]) : 100U), renderer);
+        }
+        else if (command(cmd, "/batch"))
+        {
+            const char * file = std::strtok(cmd + 6, del);
+
+            if (file)
+                eng->batch(file);
         }
-        else if (!std::strcmp(cmd, "/df"))
+        else if (command(cmd, "/df"))
         {
-            eng->docfreq();
+            eng->docfreq(std::strtok(cmd + 3, del));
         }
-        else if (!std::strncmp(cmd, "/tf", 3))
+        else if (command(cmd, "/tf"))
         {
             const char * tok[] = { std::strtok(cmd + 3, del), std::strtok(nullptr, del) };
 
             if (tok[0] && tok[1])
                 eng->trmfreq(std::atoi(tok[1]), tok[0]);
         }
+        else if (command(cmd, "/trace"))
+        {
+            const char * file = std::strtok(cmd + 6, del);
+
+            if (file)
+                Trace::dump(file);
+        }
+
+        // Dump the spans of any command slower than the threshold
+        if (threshold >= 0 && Trace::now() - started > 1000000L * threshold)
+        {
+            char file[64];
+            std::sprintf(file, "slow-%u.json", ++slow);
+
+            if (Trace::dump(file, started))
+                std::cerr << "<Message>: Slow command traced into " << file << std::endl;
+        }
     } while (std::strcmp(cmd, "/exit"));
 
     delete eng;
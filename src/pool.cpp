@@ -0,0 +1,150 @@
+/* C++ Work Stealing Thread Pool implementation by Vasileios Sioros */
+
+#include "pool.h"
+
+static unsigned long pack(const unsigned begin, const unsigned end)
+{
+    return ((unsigned long) begin << 32) | end;
+}
+
+// Pool Implementation:
+Pool::Pool(const unsigned threads)
+:
+threads(threads ? threads : 1), workers(new std::thread*[this->threads]), ranges(new std::atomic<unsigned long>[this->threads]),
+task(nullptr), arg(nullptr), generation(0UL), active(0), stop(false)
+{
+    for (unsigned w = 0; w < this->threads; w++)
+        ranges[w] = pack(0, 0);
+
+    // The calling thread acts as the 0th worker
+    for (unsigned w = 1; w < this->threads; w++)
+        workers[w] = new std::thread(worker, this, w);
+}
+
+Pool::~Pool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+
+    wake.notify_all();
+
+    for (unsigned w = 1; w < threads; w++)
+    {
+        workers[w]->join();
+        delete workers[w];
+    }
+
+    delete[] ranges;
+    delete[] workers;
+}
+
+// Take the last of the thread's own tasks
+bool Pool::take(const unsigned w, unsigned& t)
+{
+    unsigned long range = ranges[w].load();
+    for (;;)
+    {
+        const unsigned begin = (unsigned) (range >> 32), end = (unsigned) range;
+        if (begin >= end)
+            return false;
+
+        if (ranges[w].compare_exchange_weak(range, pack(begin, end - 1)))
+        {
+            t = end - 1;
+            return true;
+        }
+    }
+}
+
+// Take the first of the tasks of another thread, the victims being tried in turn
+bool Pool::steal(const unsigned w, unsigned& t)
+{
+    for (unsigned i = 1; i < threads; i++)
+    {
+        const unsigned victim = (w + i) % threads;
+
+        unsigned long range = ranges[victim].load();
+        for (;;)
+        {
+            const unsigned begin = (unsigned) (range >> 32), end = (unsigned) range;
+            if (begin >= end)
+                break;
+
+            if (ranges[victim].compare_exchange_weak(range, pack(begin + 1, end)))
+            {
+                t = begin;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// No task is ever added during a job, so once every range
+// has been found empty the thread has nothing left to do
+void Pool::work(const unsigned w)
+{
+    for (unsigned t; take(w, t) || steal(w, t); )
+        task(arg, t);
+}
+
+void Pool::worker(Pool * pool, const unsigned w)
+{
+    unsigned long seen = 0UL;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            while (!pool->stop && pool->generation == seen)
+                pool->wake.wait(guard);
+
+            if (pool->stop)
+                return;
+
+            seen = pool->generation;
+        }
+
+        pool->work(w);
+
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            if (!--pool->active)
+                pool->done.notify_one();
+        }
+    }
+}
+
+bool Pool::run(Task task, void * arg, const unsigned tasks)
+{
+    std::unique_lock<std::mutex> busy(running, std::try_to_lock);
+    if (!busy.owns_lock())
+        return false;
+
+    this->task = task;
+    this->arg = arg;
+
+    for (unsigned w = 0; w < threads; w++)
+        ranges[w] = pack((unsigned) ((unsigned long) tasks * w / threads), (unsigned) ((unsigned long) tasks * (w + 1) / threads));
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        active = threads - 1;
+        generation++;
+    }
+
+    wake.notify_all();
+
+    work(0);
+
+    // Wait for every worker to leave the job, not only for the tasks to
+    // be run, so that none of them can mistake the next job for this one
+    std::unique_lock<std::mutex> guard(lock);
+    while (active)
+        done.wait(guard);
+
+    return true;
+}
@@ -0,0 +1,55 @@
+/* C++ Work Stealing Thread Pool implementation by Vasileios Sioros */
+
+#ifndef __POOL__
+#define __POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs the tasks 0, 1, ..., n - 1 of a job on its threads and the calling
+// one: each thread is dealt a contiguous range of the tasks, which it consumes
+// from its end, and once out of tasks it steals from the start of the others'
+class Pool
+{
+public:
+
+    typedef void (*Task)(void *, const unsigned);
+
+private:
+
+    const unsigned threads;     // Including the calling thread
+    std::thread ** const workers;
+
+    // Each thread's remaining tasks [begin, end), packed as begin << 32 | end
+    std::atomic<unsigned long> * const ranges;
+
+    Task task;
+    void * arg;
+
+    std::mutex lock, running;   // The latter is held throughout a job
+    std::condition_variable wake, done;
+    unsigned long generation;   // Jobs started
+    unsigned active;            // Workers yet to finish the current job
+    bool stop;
+
+    bool take(const unsigned, unsigned&);
+    bool steal(const unsigned, unsigned&);
+    void work(const unsigned);
+
+    static void worker(Pool *, const unsigned);
+
+public:
+
+    Pool(const unsigned);
+    ~Pool();
+
+    unsigned size() const { return threads; }
+
+    // Block until all the tasks have been run; fail, without running any,
+    // if another thread's job is in progress
+    bool run(Task, void *, const unsigned);
+};
+
+#endif
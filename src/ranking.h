@@ -0,0 +1,115 @@
+/* C++ Ranking Function Policies by Vasileios Sioros */
+
+#ifndef __RANKING__
+#define __RANKING__
+
+#include "lexicon.h"
+#include <cmath>
+
+// Every policy splits its scoring function in three parts so that the
+// search loop only performs the (inlined) per term arithmetic:
+//
+//   weight(plist, N)      : computed once per query term
+//   norm(words, avgdl)    : computed once per document, when the engine is built
+//   term(weight, fq, norm): the contribution of a term that occurs fq (> 0) times
+//
+// while bound(weight, maxFrequency) bounds the absolute value of a term's
+// contribution to any document, which is what long query pruning relies on
+
+// Okapi BM25
+struct BM25Rank
+{
+    const double k, b;
+
+    BM25Rank(const double k, const double b) : k(k), b(b) {}
+
+    double weight(const PList * l, const unsigned) const { return l->IDF * (k + 1.0); }
+
+    double norm(const unsigned words, const double avgdl) const
+    {
+        return k * (1.0 - b + b * (double) words / avgdl);
+    }
+
+    double term(const double weight, const double fq, const double norm) const
+    {
+        return weight * fq / (fq + norm);
+    }
+
+    double bound(const double weight, const unsigned) const { return std::fabs(weight); }
+};
+
+// BM25+ (Lv & Zhai), lower-bounding the contribution of an occurring term by delta
+struct BM25PlusRank
+{
+    static constexpr double delta = 1.0;
+
+    const double k, b;
+
+    BM25PlusRank(const double k, const double b) : k(k), b(b) {}
+
+    double weight(const PList * l, const unsigned) const { return l->IDF; }
+
+    double norm(const unsigned words, const double avgdl) const
+    {
+        return k * (1.0 - b + b * (double) words / avgdl);
+    }
+
+    double term(const double weight, const double fq, const double norm) const
+    {
+        return weight * ((fq * (k + 1.0)) / (fq + norm) + delta);
+    }
+
+    double bound(const double weight, const unsigned) const { return std::fabs(weight) * (k + 1.0 + delta); }
+};
+
+// BM25L (Lv & Zhai), shifting the length normalized term frequency by delta
+struct BM25LRank
+{
+    static constexpr double delta = 0.5;
+
+    const double k, b;
+
+    BM25LRank(const double k, const double b) : k(k), b(b) {}
+
+    double weight(const PList * l, const unsigned) const { return l->IDF * (k + 1.0); }
+
+    double norm(const unsigned words, const double avgdl) const
+    {
+        return 1.0 / (1.0 - b + b * (double) words / avgdl);
+    }
+
+    double term(const double weight, const double fq, const double norm) const
+    {
+        const double ctd = fq * norm + delta;
+
+        return weight * ctd / (k + ctd);
+    }
+
+    double bound(const double weight, const unsigned) const { return std::fabs(weight); }
+};
+
+// Classic TF-IDF, using a logarithmic term frequency and log(N / n),
+// n being the document frequency of the full (rather than a pruned) index
+struct TFIDFRank
+{
+    TFIDFRank(const double, const double) {}
+
+    double weight(const PList * l, const unsigned N) const
+    {
+        return std::log10((double) N / (double) l->documentFrequency);
+    }
+
+    double norm(const unsigned, const double) const { return 1.0; }
+
+    double term(const double weight, const double fq, const double) const
+    {
+        return weight * (1.0 + std::log10(fq));
+    }
+
+    double bound(const double weight, const unsigned maxFrequency) const
+    {
+        return std::fabs(weight) * (1.0 + std::log10((double) maxFrequency));
+    }
+};
+
+#endif
@@ -0,0 +1,232 @@
+/* C++ Result Renderer implementation by Vasileios Sioros */
+
+#include "renderer.h"
+#include "trace.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// Renderer Implementation:
+const unsigned Renderer::spaces = 23U;
+
+static const char blanks[] = "                       "; // spaces characters
+
+Renderer::Renderer(const Mode mode)
+:
+mode(mode), tty(isatty(STDOUT_FILENO)), width(0),
+buffer(new char[4096]), used(0), capacity(4096),
+segments(new Segment[256]), size(0), max(256)
+{
+}
+
+Renderer::~Renderer()
+{
+    delete[] segments;
+    delete[] buffer;
+}
+
+// Make room for (at least) length more characters at the end of the buffer;
+// segments refer to the buffer by offset, so that it may be moved
+char * Renderer::reserve(const unsigned long length)
+{
+    if (used + length > capacity)
+    {
+        while (used + length > capacity)
+            capacity *= 2;
+
+        char * const moved = new char[capacity];
+        std::memcpy(moved, buffer, used);
+
+        delete[] buffer;
+        buffer = moved;
+    }
+
+    return buffer + used;
+}
+
+// Add a segment, extending the last one whenever the two are contiguous
+void Renderer::append(const char * base, const unsigned long offset, const unsigned long length)
+{
+    if (!length)
+        return;
+
+    if (size)
+    {
+        Segment& last = segments[size - 1];
+        if (last.base == base && last.offset + last.length == offset)
+        {
+            last.length += length;
+            return;
+        }
+    }
+
+    if (size == max)
+    {
+        Segment * const moved = new Segment[max *= 2];
+        for (unsigned i = 0; i < size; i++)
+            moved[i] = segments[i];
+
+        delete[] segments;
+        segments = moved;
+    }
+
+    segments[size].base = base;
+    segments[size].offset = offset;
+    segments[size++].length = length;
+}
+
+// Copy text into the buffer
+void Renderer::text(const char * string, const unsigned long length)
+{
+    std::memcpy(reserve(length), string, length);
+    used += length;
+
+    append(nullptr, used - length, length);
+}
+
+// A single ioctl per query, and none at all unless writing to a terminal
+void Renderer::begin()
+{
+    struct winsize w;
+
+    width = 0;
+    if (tty && !ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) && w.ws_col > spaces)
+        width = w.ws_col;
+}
+
+void Renderer::result(const unsigned rank, const unsigned id, const double score, const char * document, const unsigned qsize, const char * q[])
+{
+    Trace::Span span("render");
+
+    const unsigned len = (unsigned) std::strlen(document);
+
+    char info[64];
+
+    if (mode == COMPACT)
+    {
+        text(info, (unsigned long) std::sprintf(info, "%u\t%u\t%+.5g\t", rank + 1, id, score));
+        append(document, 0, len);
+        text("\n", 1);
+
+        return;
+    }
+
+    // Print result info (6 + 7 + 10 characters)
+    text(info, (unsigned long) std::sprintf(info, "%5u.(%5u)[%+7.5g] ", rank + 1, id, score));
+
+    // When stdout is not a terminal neither wrap nor underline the document
+    if (!width)
+    {
+        append(document, 0, len);
+        text("\n", 1);
+
+        return;
+    }
+
+    // For each query locate every instance of it
+    // in the document and underline it
+    char * const underline = reserve(len);
+    const unsigned long marks = used;
+    used += len;
+
+    for (unsigned j = 0; j < len; j++)
+        underline[j] = ' ';
+
+    for (unsigned j = 0; j < qsize; j++)
+    {
+        const unsigned qlen = (unsigned) std::strlen(q[j]);
+
+        for (const char * substr = std::strstr(document, q[j]); substr; substr = std::strstr(substr + 1, q[j]))
+        {
+            const unsigned beg = (unsigned) (substr - document);
+            const char after = substr[qlen];
+
+            if ((!after || std::isspace(after)) && (!beg || std::isspace(document[beg - 1])))
+                for (unsigned k = beg; k < beg + qlen; k++)
+                    underline[k] = '^';
+        }
+    }
+
+    const unsigned row = (len + spaces < width ? len : width - spaces);
+
+    // The first row of the document on the same line as the result info,
+    // then, row by row, the underline followed by the rest of the document
+    append(document, 0, row);
+    text("\n", 1);
+
+    for (unsigned j = 0; j < len; j += row)
+    {
+        append(blanks, 0, spaces);
+        append(nullptr, marks + j, (j + row < len ? row : len - j));
+        text("\n", 1);
+
+        append(blanks, 0, spaces);
+        if (j + row < len)
+            append(document, j + row, (j + 2 * row < len ? row : len - j - row));
+
+        text("\n", 1);
+    }
+}
+
+bool Renderer::flush()
+{
+    Trace::Span span("flush");
+
+    // Whatever has been written through cout (e.g. the prompt) goes first
+    std::cout.flush();
+
+    struct iovec vectors[IOV_MAX];
+
+    bool ok = true;
+    for (unsigned s = 0; s < size && ok; )
+    {
+        int count = 0;
+        for (; count < IOV_MAX && s < size; count++, s++)
+        {
+            const Segment& segment = segments[s];
+
+            vectors[count].iov_base = (void *) ((segment.base ? segment.base : buffer) + segment.offset);
+            vectors[count].iov_len = segment.length;
+        }
+
+        // Carry on after partial writes
+        struct iovec * v = vectors;
+        while (count)
+        {
+            const ssize_t written = writev(STDOUT_FILENO, v, count);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                ok = false;
+                break;
+            }
+
+            unsigned long left = (unsigned long) written;
+            for (; count && left >= v->iov_len; count--, v++)
+                left -= v->iov_len;
+
+            if (count)
+            {
+                v->iov_base = (char *) v->iov_base + left;
+                v->iov_len -= left;
+            }
+        }
+    }
+
+    used = 0;
+    size = 0;
+
+    return ok;
+}
@@ -0,0 +1,61 @@
+/* C++ Result Renderer implementation by Vasileios Sioros */
+
+#ifndef __RENDERER__
+#define __RENDERER__
+
+// Lays out the results of a query as a list of segments, either slices of
+// its own (reused) buffer or of the documents themselves, which are written
+// to the standard output with a single vectored write per query
+class Renderer
+{
+public:
+
+    // PRETTY: the documents wrapped to the terminal's width with every
+    //         occurrence of the query terms underlined (on a terminal only)
+    // COMPACT: a tab separated line per result (rank, ID, score, document)
+    enum Mode {
+        PRETTY,
+        COMPACT
+    };
+
+private:
+
+    static const unsigned spaces;       // Width of the result info
+
+    // Segment Implementation:
+    struct Segment
+    {
+        const char * base;      // nullptr if the segment lies in the buffer
+        unsigned long offset, length;
+    };
+
+    const Mode mode;
+    const bool tty;             // Whether the standard output is a terminal
+    unsigned width;             // The terminal's width, as of the last query
+
+    char * buffer;
+    unsigned long used, capacity;
+
+    Segment * segments;
+    unsigned size, max;
+
+    char * reserve(const unsigned long);
+    void append(const char *, const unsigned long, const unsigned long);
+    void text(const char *, const unsigned long);
+
+public:
+
+    Renderer(const Mode);
+    ~Renderer();
+
+    // Start laying out the results of a query
+    void begin();
+
+    // Lay out the result of the given rank (0-based)
+    void result(const unsigned, const unsigned, const double, const char *, const unsigned, const char * []);
+
+    // Write the query's results and start over
+    bool flush();
+};
+
+#endif
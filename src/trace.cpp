@@ -0,0 +1,113 @@
+/* C++ Trace Spans implementation by Vasileios Sioros */
+
+#include "trace.h"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <mutex>
+
+// Ring Buffer Implementation:
+const unsigned Trace::Ring::capacity = 1U << 14;
+
+Trace::Ring::Ring(const unsigned tid, Ring * next)
+:
+events(new Event[capacity]), tid(tid), recorded(0UL), next(next)
+{
+}
+
+Trace::Ring::~Ring()
+{
+    delete[] events;
+
+    if (next)
+        delete next;
+}
+
+// Trace Implementation:
+static std::mutex lock;         // Guards the list of rings
+
+Trace::Registry Trace::registry = { nullptr, 0 };
+
+Trace::Registry::~Registry()
+{
+    if (rings)
+        delete rings;
+}
+
+bool Trace::enabled = false;
+
+void Trace::enable(const bool enable)
+{
+    enabled = enable;
+}
+
+long Trace::now()
+{
+    return (long) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The ring of the calling thread, created on its first span
+Trace::Ring * Trace::ring()
+{
+    thread_local Ring * mine = nullptr;
+
+    if (!mine)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        mine = registry.rings = new Ring(++registry.threads, registry.rings);
+    }
+
+    return mine;
+}
+
+void Trace::record(const char * name, const long start, const long duration)
+{
+    Ring * const r = ring();
+
+    Ring::Event& event = r->events[r->recorded++ % Ring::capacity];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+}
+
+// Complete ("X") events, one per span, their timestamps and durations in
+// (fractional) microseconds as the format expects; the rings are expected
+// to be dumped while no thread is recording into them
+bool Trace::dump(const char * filename, const long since)
+{
+    std::ofstream ofs(filename);
+    if (!ofs.is_open())
+    {
+        std::cerr << "<Error>: Unable to write the trace file" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    ofs << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+    bool first = true;
+    for (const Ring * r = registry.rings; r; r = r->next)
+    {
+        const unsigned long kept = (r->recorded < Ring::capacity ? r->recorded : Ring::capacity);
+
+        for (unsigned long i = r->recorded - kept; i < r->recorded; i++)
+        {
+            const Ring::Event& event = r->events[i % Ring::capacity];
+            if (event.start < since)
+                continue;
+
+            ofs << (first ? "\n" : ",\n")
+                << "{\"name\":\"" << event.name << "\",\"cat\":\"minisearch\",\"ph\":\"X\",\"ts\":" << (double) event.start / 1000.0
+                << ",\"dur\":" << (double) event.duration / 1000.0 << ",\"pid\":1,\"tid\":" << r->tid << '}';
+
+            first = false;
+        }
+    }
+
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+    return ofs.good();
+}
@@ -0,0 +1,69 @@
+/* C++ Trace Spans implementation by Vasileios Sioros */
+
+#ifndef __TRACE__
+#define __TRACE__
+
+// Every thread records the spans it completes into a ring buffer of its
+// own, overwriting the oldest ones once full; the rings of all the threads
+// can be dumped in Chrome trace event format (chrome://tracing, Perfetto)
+class Trace
+{
+    // Ring Buffer Implementation:
+    struct Ring
+    {
+        static const unsigned capacity;
+
+        struct Event
+        {
+            const char * name;  // A string literal
+            long start, duration;
+        } * const events;
+
+        const unsigned tid;
+        unsigned long recorded; // Events ever recorded, the latest capacity of which are kept
+
+        Ring * const next;
+
+        Ring(const unsigned, Ring *);
+        ~Ring();
+    };
+
+    // Every thread's ring, released at exit
+    static struct Registry
+    {
+        Ring * rings;
+        unsigned threads;
+
+        ~Registry();
+    } registry;
+
+    static bool enabled;
+
+    static Ring * ring();
+    static void record(const char *, const long, const long);
+
+public:
+
+    // Span Implementation:
+    // Measures the lifetime of a scope
+    class Span
+    {
+        const char * const name;
+        const long start;
+
+    public:
+
+        Span(const char * name) : name(name), start(enabled ? now() : 0L) {}
+        ~Span() { if (enabled) record(name, start, now() - start); }
+    };
+
+    static void enable(const bool);
+
+    // Nanoseconds since an arbitrary, fixed point in time
+    static long now();
+
+    // Write the spans started no earlier than since to the given file
+    static bool dump(const char *, const long since = 0L);
+};
+
+#endif
@@ -2,23 +2,9 @@
 
 #include "trie.h"
 #include "stack.h"
+#include "louds.h"
 #include <cstring>
 #include <iostream>
-#include <cmath>
-
-// Posting List Implementation:
-PList::PList(const unsigned total)
-:
-IDF(0.0), documentNum(0), instances(new unsigned[total])
-{
-    for (unsigned i = 0; i < total; i++)
-        instances[i] = 0;
-}
-
-PList::~PList()
-{
-    delete[] instances;
-}
 
 // Node Implementation:
 Trie::Node::Node()
@@ -39,7 +25,7 @@ Trie::Node::~Node()
         delete sibling;
 
     if (plist)
-        delete plist;
+        destroy(plist);
 }
 
 // Using a stack in order to store "consumed" characters (prefix)
@@ -61,10 +47,25 @@ void Trie::Node::print() const
         sibling->print();
 }
 
+// Depth first traversal, keeping the "consumed" characters (prefix) in word
+void Trie::Node::visit(Visitor visitor, void * arg, char * word, const unsigned depth) const
+{
+    word[depth] = *letter; word[depth + 1] = '\0';
+
+    if (plist)
+        visitor(word, plist, arg);
+
+    if (child)
+        child->visit(visitor, arg, word, depth + 1);
+
+    if (sibling)
+        sibling->visit(visitor, arg, word, depth);
+}
+
 // Trie Implementation:
 Trie::Trie(const unsigned total)
 :
-total(total)
+Lexicon(total), nodes(1)
 {
 }
 
@@ -103,11 +104,18 @@ void Trie::add(const char * string, const unsigned documentId)
     {
         Node * node = new Node();
         node->letter = new char(string[i]);
+        nodes++;
 
         if (!current->child)
         {
             current = current->child = node;
         }
+        else if (*(node->letter) < *(current->child->letter))
+        {
+            // The node precedes every sibling
+            node->sibling = current->child;
+            current = current->child = node;
+        }
         else
         {
             // Insert node in the list of siblings in a specific
@@ -127,14 +135,9 @@ void Trie::add(const char * string, const unsigned documentId)
 
     // Update node' s Posting List & IDF
     if (!current->plist)
-        current->plist = new PList(total);
+        current->plist = create();
 
-    if (!current->plist->instances[documentId]++)
-        current->plist->documentNum++;
-
-    const double N = (double) total, n = (double) current->plist->documentNum;
-    
-    current->plist->IDF = std::log10((N - n + 0.5) / (n + 0.5));
+    update(current->plist, documentId);
 }
 
 // Used the same method of traversing
@@ -171,6 +174,136 @@ const PList * Trie::lookup(const char * string) const
     return (i == len ? current->plist : nullptr);
 }
 
+void Trie::visit(Visitor visitor, void * arg) const
+{
+    char word[512];
+
+    if (root.child)
+        root.child->visit(visitor, arg, word, 0);
+}
+
+// Descend to the node of the prefix and visit its subtree
+void Trie::prefix(const char * string, Visitor visitor, void * arg) const
+{
+    const unsigned len = std::strlen(string);
+    if (len >= 512)
+        return;
+
+    const Node * current = &root;
+    for (unsigned i = 0; i < len; i++)
+    {
+        const Node * next = current->child;
+        for (; next && *(next->letter) < string[i]; next = next->sibling);
+
+        if (!next || *(next->letter) != string[i])
+            return;
+
+        current = next;
+    }
+
+    char word[512];
+    std::strcpy(word, string);
+
+    if (current != &root && current->plist)
+        visitor(word, current->plist, arg);
+
+    if (current->child)
+        current->child->visit(visitor, arg, word, len);
+}
+
+// Walk the children of a node, in lexicographic order, feeding each letter
+// to the Levenshtein automaton and pruning every branch whose automaton state
+// cannot reach an accepting one i.e. whose row's minimum exceeds the distance
+void Trie::fuzzy(const Node * first, Fuzzy& search, const unsigned depth) const
+{
+    const unsigned * const previous = search.rows + depth * (search.len + 1);
+    unsigned * const row = search.rows + (depth + 1) * (search.len + 1);
+
+    for (const Node * next = first; next; next = next->sibling)
+    {
+        const unsigned min = advance(previous, row, search.term, search.len, *(next->letter));
+        if (min > search.distance)
+            continue;
+
+        search.word[depth] = *(next->letter); search.word[depth + 1] = '\0';
+
+        if (next->plist && row[search.len] <= search.distance)
+            offer(search.matches, search.size, search.max, search.word, next->plist, row[search.len]);
+
+        if (next->child)
+            fuzzy(next->child, search, depth + 1);
+    }
+}
+
+unsigned Trie::fuzzy(const char * term, const unsigned distance, Match matches[], const unsigned max) const
+{
+    Fuzzy search;
+
+    search.term = term; search.len = (unsigned) std::strlen(term); search.distance = distance;
+    search.matches = matches; search.size = 0; search.max = max;
+
+    // A branch cannot get deeper than len + distance letters without failing
+    search.rows = new unsigned[(search.len + distance + 2) * (search.len + 1)];
+    for (unsigned i = 0; i <= search.len; i++)
+        search.rows[i] = i;
+
+    if (root.child)
+        fuzzy(root.child, search, 0);
+
+    delete[] search.rows;
+
+    return search.size;
+}
+
+// Lay the nodes out in breadth first order and hand them, along with
+// their Posting Lists, over to a succinct (LOUDS) trie
+Lexicon * Trie::freeze()
+{
+    const Node ** const queue = new const Node*[nodes];
+    unsigned * const degrees = new unsigned[nodes];
+    char * const letters = new char[nodes];
+    PList ** const plists = new PList*[nodes];
+
+    unsigned head = 0, tail = 0;
+    for (queue[tail++] = &root; head < tail; head++)
+    {
+        const Node * const node = queue[head];
+
+        degrees[head] = 0;
+        for (const Node * next = node->child; next; next = next->sibling, degrees[head]++)
+            queue[tail++] = next;
+
+        letters[head] = (node->letter ? *(node->letter) : '\0');
+        plists[head] = node->plist;
+
+        const_cast<Node *>(node)->plist = nullptr;
+    }
+
+    Lexicon * const louds = new Louds(total, nodes, degrees, letters, plists);
+
+    delete[] plists;
+    delete[] letters;
+    delete[] degrees;
+    delete[] queue;
+
+    return louds;
+}
+
+// Estimate the memory a (glibc) malloc of the given size takes up: its size
+// plus an 8 byte header, rounded up to 16 bytes and no less than 32 bytes
+static unsigned long allocation(const unsigned long size)
+{
+    const unsigned long chunk = (size + 8UL + 15UL) & ~15UL;
+
+    return (chunk < 32UL ? 32UL : chunk);
+}
+
+// Every node but the root is allocated on its own and so is its letter
+unsigned long Trie::bytes() const
+{
+    return sizeof(*this) + (nodes - 1) * (allocation(sizeof(Node)) + allocation(sizeof(char)));
+}
+
 void Trie::print() const
 {
     const Node * next = root.child;
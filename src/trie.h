@@ -3,23 +3,9 @@
 #ifndef __TRIE__
 #define __TRIE__
 
-// Posting List Implementation:
-class PList
-{
-    friend class Trie;
-    
-    PList(const unsigned);
-    ~PList();
+#include "lexicon.h"
 
-public:
-    
-    double IDF;                 // Inverse Document Frequency
-    unsigned documentNum;       // Counter of non-zero entries
-    unsigned * const instances; // Pairs of: (1) Document IDs        (i)
-                                // and       (2) Word Usage Counters (instances[i])
-};
-
-class Trie
+class Trie : public Lexicon
 {
     // Node Implementation:
     struct Node
@@ -33,9 +19,25 @@ class Trie
         ~Node();
 
         void print() const;
+        void visit(Visitor, void *, char *, const unsigned) const;
     } root;
 
-    const unsigned total;       // Allocation size of this trie's PList::instances
+    // Fuzzy Search Implementation:
+    struct Fuzzy
+    {
+        const char * term;
+        unsigned len, distance;
+
+        unsigned * rows;        // A row of the automaton per depth
+        char word[512];
+
+        Match * matches;
+        unsigned size, max;
+    };
+
+    void fuzzy(const Node *, Fuzzy&, const unsigned) const;
+
+    unsigned nodes;             // Number of nodes, the root included
 
 public:
     
@@ -43,6 +45,13 @@ public:
 
     void add(const char *, const unsigned);
     const PList * lookup(const char *) const;
+    void visit(Visitor, void *) const;
+    void prefix(const char *, Visitor, void *) const;
+    unsigned fuzzy(const char *, const unsigned, Match [], const unsigned) const;
+
+    Lexicon * freeze();
+    unsigned long bytes() const;
+
     void print() const;
 };
 